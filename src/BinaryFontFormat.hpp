@@ -0,0 +1,188 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Layout of the binary font description (FontDescriptionType::Binary).
+//
+// All values are little-endian and all offsets are relative to the start of the file.
+// Every section starts at a multiple of section_alignment bytes, so that a loader can map the
+// file into memory and use its tables in place, without any parsing.
+//
+// File layout:
+//   FileHeader
+//   Strings          (UTF-8, null-terminated)
+//   PageEntry        [page_count]
+//   PageGroupRange   [...], referenced by the page groups
+//   PageGroupEntry   [page_group_count]
+//   Glyph arrays     (one array per GlyphTable member, each glyph_count long)
+//   GlyphTable
+//   Per variation:   glyph indices, then the two-level code point index
+//   VariationEntry   [variation_count]
+//
+// The code point index of a variation consists of a uint16_t[256] table that maps the high
+// byte of a code point to a block number, followed by blocks of uint32_t[256] that map the
+// low byte to an index into the glyph arrays:
+//
+//   const uint16_t block = level1[cp >> 8];
+//   const uint32_t glyph = block == no_index_block ? no_glyph : blocks[block][cp & 0xFF];
+namespace bmfgen::binary_format
+{
+constexpr std::array<char, 4> magic             = {'B', 'M', 'F', 'G'};
+constexpr uint32_t            version           = 1;
+constexpr uint32_t            section_alignment = 16;
+constexpr uint16_t            no_index_block    = 0xFFFF;
+constexpr uint32_t            no_glyph          = 0xFFFFFFFF;
+
+struct FileHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t file_size;
+    int32_t  base_size;
+    uint32_t name_offset;
+    uint32_t page_count;
+    uint32_t page_table_offset;
+    uint32_t glyph_count;
+    uint32_t glyph_table_offset;
+    uint32_t variation_count;
+    uint32_t variation_table_offset;
+    uint32_t page_group_count;
+    uint32_t page_group_table_offset;
+    uint32_t reserved[3];
+};
+
+struct PageEntry
+{
+    uint32_t filename_offset;
+    uint32_t width;
+    uint32_t height;
+    uint32_t reserved;
+};
+
+struct PageGroupRange
+{
+    uint32_t first;
+    uint32_t last;
+};
+
+struct PageGroupEntry
+{
+    uint32_t name_offset;
+    uint32_t first_page_index;
+    uint32_t page_count;
+    uint32_t range_count;
+    uint32_t ranges_offset;
+    uint32_t reserved[3];
+};
+
+// Offsets of the glyph arrays (structure of arrays).
+struct GlyphTable
+{
+    uint32_t code_points_offset;        // uint32_t[]
+    uint32_t x_offset;                  // uint16_t[]
+    uint32_t y_offset;                  // uint16_t[]
+    uint32_t width_offset;              // uint16_t[]
+    uint32_t height_offset;             // uint16_t[]
+    uint32_t page_index_offset;         // uint16_t[]
+    uint32_t horizontal_advance_offset; // int16_t[]
+    uint32_t left_bearing_offset;       // int16_t[]
+    uint32_t right_bearing_offset;      // int16_t[]
+    uint32_t frequency_rank_offset;     // int32_t[]
+    uint32_t channel_offset;            // int8_t[], see Glyph::channel (-1 if absent)
+    uint32_t reserved;
+};
+
+struct VariationEntry
+{
+    float    scale_factor;
+    int32_t  pixel_size;
+    int32_t  line_height;
+    int32_t  ascent;
+    int32_t  descent;
+    int32_t  line_gap;
+    int32_t  underline_position;
+    uint32_t glyph_count;
+    uint32_t glyph_indices_offset; // uint32_t[glyph_count]
+    uint32_t index_offset;         // uint16_t[256], followed by uint32_t[index_block_count][256]
+    uint32_t index_block_count;
+    uint32_t reserved;
+};
+
+// Layout of a font bundle (FontDescriptionType::Bundle), a single file that contains the binary
+// font description and the pixel data of all pages.
+//
+// Every section starts at a multiple of bundle_section_alignment bytes, so that a loader can
+// map the file and upload pages straight from the mapping.
+//
+// File layout:
+//   BundleHeader
+//   Binary font description (offsets are relative to its start, page filenames are empty)
+//   BundlePageEntry [page_count]
+//   Page data, one section per page
+//
+// Uncompressed pages consist of tightly packed rows (row_pitch bytes each, top row first).
+// Gray4 and Gray1 rows are padded to whole bytes.
+// Pages with more than one level store their mip chain largest first: level n is
+// max(width >> n, 1) x max(height >> n, 1) pixels and follows level n - 1 directly, with rows
+// packed the same way. row_pitch refers to level 0.
+// Compressed pages are zlib streams of the same data.
+constexpr std::array<char, 4> bundle_magic             = {'B', 'M', 'F', 'B'};
+constexpr uint32_t            bundle_version           = 1;
+constexpr uint32_t            bundle_section_alignment = 4096;
+
+enum class BundlePixelFormat : uint32_t
+{
+    Rgba8                    = 0, // Straight alpha, byte order R, G, B, A
+    Gray8                    = 1, // Alpha (coverage) only
+    Gray4                    = 2, // Coverage, 2 pixels per byte, high nibble first
+    Gray1                    = 3, // Coverage, 8 pixels per byte, most significant bit first
+    Rgba8Premultiplied       = 4, // Premultiplied alpha, byte order R, G, B, A
+    Rgba8LinearPremultiplied = 5, // Premultiplied in linear space, then sRGB-encoded
+};
+
+enum class BundleCompression : uint32_t
+{
+    None = 0,
+    Zlib = 1,
+};
+
+struct BundleHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t section_alignment;
+    uint32_t page_count;
+    uint64_t descriptor_offset;
+    uint64_t descriptor_size;
+    uint64_t page_table_offset;
+    uint64_t file_size;
+    uint32_t reserved[4];
+};
+
+struct BundlePageEntry
+{
+    uint32_t          width;
+    uint32_t          height;
+    uint32_t          row_pitch;
+    BundlePixelFormat pixel_format;
+    BundleCompression compression;
+    uint32_t          level_count; // 1 without mipmaps
+    uint64_t          data_offset;
+    uint64_t          data_size;
+    uint64_t          uncompressed_size;
+};
+
+static_assert(sizeof(FileHeader) == 64);
+static_assert(sizeof(PageEntry) == 16);
+static_assert(sizeof(PageGroupRange) == 8);
+static_assert(sizeof(PageGroupEntry) == 32);
+static_assert(sizeof(GlyphTable) == 48);
+static_assert(sizeof(VariationEntry) == 48);
+static_assert(sizeof(BundleHeader) == 64);
+static_assert(sizeof(BundlePageEntry) == 48);
+} // namespace bmfgen::binary_format
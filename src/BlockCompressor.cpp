@@ -0,0 +1,759 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "BlockCompressor.hpp"
+
+#include <QImage>
+#include <QList>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define BMFGEN_HAS_SSE2
+#endif
+
+using GrayBlock = std::array<uint8_t, 16>;
+using RgbaBlock = std::array<std::array<uint8_t, 4>, 16>;
+
+// Bit weights of BC7's 4-bit indices.
+static constexpr std::array<int, 16> s_bc7_weights = {
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+static void store_u64_le(uchar* dst, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        dst[i] = static_cast<uchar>(value >> (i * 8));
+    }
+}
+
+// Writes the pixels of a 4x4 block, clamping coordinates at the image's edges.
+template <typename Block, typename LoadPixel>
+static void load_block(
+    const QImage& image, int block_x, int block_y, Block& block, LoadPixel&& load)
+{
+    const int max_x = image.width() - 1;
+    const int max_y = image.height() - 1;
+
+    for (int y = 0; y < 4; ++y)
+    {
+        const uchar* row = image.constScanLine(std::min(block_y * 4 + y, max_y));
+
+        for (int x = 0; x < 4; ++x)
+        {
+            load(row, std::min(block_x * 4 + x, max_x), block[y * 4 + x]);
+        }
+    }
+}
+
+// Runs encode_row(block_y, dst) for every row of blocks in parallel.
+template <typename EncodeRow>
+static QByteArray compress_rows(const QImage& image, BlockFormat format, EncodeRow&& encode_row)
+{
+    const int       blocks_x      = (image.width() + 3) / 4;
+    const int       blocks_y      = (image.height() + 3) / 4;
+    const qsizetype row_byte_size = qsizetype(blocks_x) * BlockCompressor::bytes_per_block(format);
+
+    QByteArray data(row_byte_size * blocks_y, Qt::Uninitialized);
+
+    QList<int> rows(blocks_y);
+    std::iota(rows.begin(), rows.end(), 0);
+
+    uchar* const dst = reinterpret_cast<uchar*>(data.data());
+
+    QtConcurrent::blockingMap(rows, [&](int block_y) {
+        encode_row(block_y, dst + block_y * row_byte_size);
+    });
+
+    return data;
+}
+
+int BlockCompressor::bytes_per_block(BlockFormat format)
+{
+    return format == BlockFormat::Bc4 ? 8 : 16;
+}
+
+qsizetype BlockCompressor::compressed_size(BlockFormat format, int width, int height)
+{
+    return qsizetype((width + 3) / 4) * ((height + 3) / 4) * bytes_per_block(format);
+}
+
+/*
+ * BC4
+ */
+
+static void min_max(const GrayBlock& values, uint8_t& min, uint8_t& max)
+{
+#ifdef BMFGEN_HAS_SSE2
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values.data()));
+    __m128i hi = lo;
+
+    lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 8));
+    hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 8));
+    lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 4));
+    hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 4));
+    lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 2));
+    hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 2));
+    lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 1));
+    hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 1));
+
+    min = static_cast<uint8_t>(_mm_cvtsi128_si32(lo) & 0xFF);
+    max = static_cast<uint8_t>(_mm_cvtsi128_si32(hi) & 0xFF);
+#else
+    const auto [min_it, max_it] = std::minmax_element(values.begin(), values.end());
+    min                         = *min_it;
+    max                         = *max_it;
+#endif
+}
+
+// Chooses the nearest palette entry for every value. Returns the packed block and its error.
+static std::pair<uint64_t, int> fit_bc4_block(const GrayBlock&              values,
+                                              uint8_t                       e0,
+                                              uint8_t                       e1,
+                                              const std::array<uint8_t, 8>& palette)
+{
+    uint64_t bits  = uint64_t(e0) | (uint64_t(e1) << 8);
+    int      error = 0;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        int best_index = 0;
+        int best_error = std::numeric_limits<int>::max();
+
+        for (int p = 0; p < 8; ++p)
+        {
+            const int diff = int(values[i]) - int(palette[p]);
+            if (diff * diff < best_error)
+            {
+                best_error = diff * diff;
+                best_index = p;
+            }
+        }
+
+        bits |= uint64_t(best_index) << (16 + i * 3);
+        error += best_error;
+    }
+
+    return {bits, error};
+}
+
+static uint64_t encode_bc4_block(const GrayBlock& values)
+{
+    uint8_t min{};
+    uint8_t max{};
+    min_max(values, min, max);
+
+    if (min == max)
+    {
+        return uint64_t(min) | (uint64_t(min) << 8);
+    }
+
+    // Eight interpolated values between the extremes (e0 > e1).
+    std::array<uint8_t, 8> palette8{max, min};
+    for (int i = 1; i < 7; ++i)
+    {
+        palette8[i + 1] = uint8_t(((7 - i) * max + i * min + 3) / 7);
+    }
+
+    auto best = fit_bc4_block(values, max, min, palette8);
+
+    // Six interpolated values plus exact 0 and 255 (e0 <= e1). Glyph coverage is mostly
+    // fully transparent or fully opaque, which this mode represents without error.
+    if (min == 0 || max == 255)
+    {
+        uint8_t inner_min = 255;
+        uint8_t inner_max = 0;
+
+        for (const uint8_t value : values)
+        {
+            if (value != 0 && value != 255)
+            {
+                inner_min = std::min(inner_min, value);
+                inner_max = std::max(inner_max, value);
+            }
+        }
+
+        if (inner_min > inner_max)
+        {
+            inner_min = inner_max = 0;
+        }
+
+        std::array<uint8_t, 8> palette6{inner_min, inner_max};
+        for (int i = 1; i < 5; ++i)
+        {
+            palette6[i + 1] = uint8_t(((5 - i) * inner_min + i * inner_max + 2) / 5);
+        }
+        palette6[6] = 0;
+        palette6[7] = 255;
+
+        const auto alternative = fit_bc4_block(values, inner_min, inner_max, palette6);
+
+        if (alternative.second < best.second)
+        {
+            best = alternative;
+        }
+    }
+
+    return best.first;
+}
+
+QByteArray BlockCompressor::compress_bc4(const QImage& image)
+{
+    Q_ASSERT(image.format() == QImage::Format_Grayscale8);
+
+    const int blocks_x = (image.width() + 3) / 4;
+
+    return compress_rows(image, BlockFormat::Bc4, [&](int block_y, uchar* dst) {
+        GrayBlock block{};
+
+        for (int block_x = 0; block_x < blocks_x; ++block_x)
+        {
+            load_block(image, block_x, block_y, block, [](const uchar* row, int x, uint8_t& out) {
+                out = row[x];
+            });
+
+            store_u64_le(dst + block_x * 8, encode_bc4_block(block));
+        }
+    });
+}
+
+/*
+ * BC7 (mode 6: one subset, 7-bit RGBA endpoints with a shared p-bit each, 4-bit indices)
+ */
+
+#ifdef BMFGEN_HAS_SSE2
+// Returns the channels of a pixel as floats.
+static inline __m128 load_pixel_ps(const std::array<uint8_t, 4>& pixel)
+{
+    int32_t value{};
+    std::memcpy(&value, pixel.data(), sizeof(value));
+
+    const __m128i zero = _mm_setzero_si128();
+
+    return _mm_cvtepi32_ps(
+        _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero));
+}
+
+// Returns channel c of four RGBA pixels as floats.
+static inline __m128 channel_ps(__m128i pixels, int c)
+{
+    return _mm_cvtepi32_ps(
+        _mm_and_si128(_mm_srl_epi32(pixels, _mm_cvtsi32_si128(c * 8)), _mm_set1_epi32(0xFF)));
+}
+
+// SSE2 lacks a signed 32-bit minimum.
+static inline __m128i min_epi32(__m128i a, __m128i b)
+{
+    const __m128i a_is_less = _mm_cmplt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(a_is_less, a), _mm_andnot_si128(a_is_less, b));
+}
+#endif
+
+struct Bc7Endpoint
+{
+    std::array<int, 4> quantized{}; // 7 bits per channel
+    int                p_bit{};
+
+    int value(int channel) const
+    {
+        return (quantized[channel] << 1) | p_bit;
+    }
+};
+
+struct Bc7Fit
+{
+    Bc7Endpoint         e0;
+    Bc7Endpoint         e1;
+    std::array<int, 16> indices{};
+    int                 error{std::numeric_limits<int>::max()};
+};
+
+static Bc7Endpoint quantize_endpoint(const std::array<float, 4>& color)
+{
+    Bc7Endpoint best;
+    float       best_error = std::numeric_limits<float>::max();
+
+    for (int p_bit = 0; p_bit < 2; ++p_bit)
+    {
+        Bc7Endpoint candidate;
+        candidate.p_bit = p_bit;
+
+        float error = 0;
+
+        for (int c = 0; c < 4; ++c)
+        {
+            const int q = std::clamp(int(std::lround((color[c] - float(p_bit)) * 0.5f)), 0, 127);
+            candidate.quantized[c] = q;
+
+            const float diff = float((q << 1) | p_bit) - color[c];
+            error += diff * diff;
+        }
+
+        if (error < best_error)
+        {
+            best_error = error;
+            best       = candidate;
+        }
+    }
+
+    return best;
+}
+
+static void assign_indices(const RgbaBlock& block, Bc7Fit& fit)
+{
+    std::array<std::array<int, 4>, 16> palette{};
+
+    for (int i = 0; i < 16; ++i)
+    {
+        const int w = s_bc7_weights[i];
+
+        for (int c = 0; c < 4; ++c)
+        {
+            palette[i][c] = ((64 - w) * fit.e0.value(c) + w * fit.e1.value(c) + 32) >> 6;
+        }
+    }
+
+    fit.error = 0;
+
+#ifdef BMFGEN_HAS_SSE2
+    // Two palette entries per vector, 16 bits per channel.
+    std::array<__m128i, 8> entry_pairs{};
+
+    for (int p = 0; p < 8; ++p)
+    {
+        const auto& a = palette[p * 2];
+        const auto& b = palette[p * 2 + 1];
+
+        entry_pairs[p] = _mm_setr_epi16(short(a[0]),
+                                        short(a[1]),
+                                        short(a[2]),
+                                        short(a[3]),
+                                        short(b[0]),
+                                        short(b[1]),
+                                        short(b[2]),
+                                        short(b[3]));
+    }
+
+    for (int i = 0; i < 16; ++i)
+    {
+        const auto&   px    = block[i];
+        const __m128i pixel = _mm_setr_epi16(
+            px[0], px[1], px[2], px[3], px[0], px[1], px[2], px[3]);
+
+        // Errors are combined with their palette index (error * 16 + index), so that the
+        // minimum prefers the lowest index among equal errors, as the scalar search does.
+        __m128i best = _mm_set1_epi32(std::numeric_limits<int>::max());
+
+        for (int q = 0; q < 4; ++q)
+        {
+            const __m128i d0 = _mm_sub_epi16(pixel, entry_pairs[q * 2]);
+            const __m128i d1 = _mm_sub_epi16(pixel, entry_pairs[q * 2 + 1]);
+
+            // Sums of two squared channels each: (R, B) and (G, A) halves of four entries.
+            const __m128 s0 = _mm_castsi128_ps(_mm_madd_epi16(d0, d0));
+            const __m128 s1 = _mm_castsi128_ps(_mm_madd_epi16(d1, d1));
+
+            const __m128i errors =
+                _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(s0, s1, _MM_SHUFFLE(2, 0, 2, 0))),
+                              _mm_castps_si128(_mm_shuffle_ps(s0, s1, _MM_SHUFFLE(3, 1, 3, 1))));
+
+            const __m128i keys = _mm_or_si128(
+                _mm_slli_epi32(errors, 4), _mm_setr_epi32(q * 4, q * 4 + 1, q * 4 + 2, q * 4 + 3));
+
+            best = min_epi32(best, keys);
+        }
+
+        best = min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2)));
+        best = min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        const int key = _mm_cvtsi128_si32(best);
+
+        fit.indices[i] = key & 15;
+        fit.error += key >> 4;
+    }
+#else
+    for (int i = 0; i < 16; ++i)
+    {
+        int best_index = 0;
+        int best_error = std::numeric_limits<int>::max();
+
+        for (int p = 0; p < 16; ++p)
+        {
+            int error = 0;
+
+            for (int c = 0; c < 4; ++c)
+            {
+                const int diff = int(block[i][c]) - palette[p][c];
+                error += diff * diff;
+            }
+
+            if (error < best_error)
+            {
+                best_error = error;
+                best_index = p;
+            }
+        }
+
+        fit.indices[i] = best_index;
+        fit.error += best_error;
+    }
+#endif
+}
+
+static Bc7Fit fit_endpoints(const RgbaBlock&            block,
+                            const std::array<float, 4>& e0,
+                            const std::array<float, 4>& e1)
+{
+    Bc7Fit fit;
+    fit.e0 = quantize_endpoint(e0);
+    fit.e1 = quantize_endpoint(e1);
+    assign_indices(block, fit);
+    return fit;
+}
+
+// Finds the endpoints along the principal axis of the block's colors.
+static std::pair<std::array<float, 4>, std::array<float, 4>> principal_endpoints(
+    const RgbaBlock& block)
+{
+    std::array<float, 4> mean{};
+
+    for (const auto& pixel : block)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            mean[c] += float(pixel[c]) / 16.0f;
+        }
+    }
+
+    std::array<std::array<float, 4>, 4> covariance{};
+
+    for (const auto& pixel : block)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                covariance[i][j] += (float(pixel[i]) - mean[i]) * (float(pixel[j]) - mean[j]);
+            }
+        }
+    }
+
+    // Power iteration, starting at the diagonal of the bounding box.
+    std::array<float, 4> axis{};
+    {
+        std::array<float, 4> min{255, 255, 255, 255};
+        std::array<float, 4> max{};
+
+        for (const auto& pixel : block)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                min[c] = std::min(min[c], float(pixel[c]));
+                max[c] = std::max(max[c], float(pixel[c]));
+            }
+        }
+
+        for (int c = 0; c < 4; ++c)
+        {
+            axis[c] = max[c] - min[c];
+        }
+    }
+
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        std::array<float, 4> next{};
+
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                next[i] += covariance[i][j] * axis[j];
+            }
+        }
+
+        const float length =
+            std::sqrt(std::inner_product(next.begin(), next.end(), next.begin(), 0.0f));
+
+        if (length < 1e-6f)
+        {
+            break;
+        }
+
+        for (int c = 0; c < 4; ++c)
+        {
+            axis[c] = next[c] / length;
+        }
+    }
+
+    float min_t = 0;
+    float max_t = 0;
+
+#ifdef BMFGEN_HAS_SSE2
+    // Projects four pixels at a time, channel by channel.
+    {
+        const auto* pixels = reinterpret_cast<const __m128i*>(block.data());
+
+        __m128 min_ts = _mm_setzero_ps();
+        __m128 max_ts = _mm_setzero_ps();
+
+        for (int k = 0; k < 4; ++k)
+        {
+            const __m128i four_pixels = _mm_loadu_si128(pixels + k);
+
+            __m128 t = _mm_setzero_ps();
+
+            for (int c = 0; c < 4; ++c)
+            {
+                const __m128 d = _mm_sub_ps(channel_ps(four_pixels, c), _mm_set1_ps(mean[c]));
+                t              = _mm_add_ps(t, _mm_mul_ps(d, _mm_set1_ps(axis[c])));
+            }
+
+            min_ts = _mm_min_ps(min_ts, t);
+            max_ts = _mm_max_ps(max_ts, t);
+        }
+
+        min_ts = _mm_min_ps(min_ts, _mm_movehl_ps(min_ts, min_ts));
+        max_ts = _mm_max_ps(max_ts, _mm_movehl_ps(max_ts, max_ts));
+        min_ts = _mm_min_ps(min_ts, _mm_shuffle_ps(min_ts, min_ts, _MM_SHUFFLE(1, 1, 1, 1)));
+        max_ts = _mm_max_ps(max_ts, _mm_shuffle_ps(max_ts, max_ts, _MM_SHUFFLE(1, 1, 1, 1)));
+
+        min_t = _mm_cvtss_f32(min_ts);
+        max_t = _mm_cvtss_f32(max_ts);
+    }
+#else
+    for (const auto& pixel : block)
+    {
+        float t = 0;
+        for (int c = 0; c < 4; ++c)
+        {
+            t += (float(pixel[c]) - mean[c]) * axis[c];
+        }
+
+        min_t = std::min(min_t, t);
+        max_t = std::max(max_t, t);
+    }
+#endif
+
+    std::array<float, 4> e0{};
+    std::array<float, 4> e1{};
+
+    for (int c = 0; c < 4; ++c)
+    {
+        e0[c] = std::clamp(mean[c] + axis[c] * min_t, 0.0f, 255.0f);
+        e1[c] = std::clamp(mean[c] + axis[c] * max_t, 0.0f, 255.0f);
+    }
+
+    return {e0, e1};
+}
+
+// Refits the endpoints to the chosen indices with least squares.
+static std::optional<std::pair<std::array<float, 4>, std::array<float, 4>>> refine_endpoints(
+    const RgbaBlock& block, const Bc7Fit& fit)
+{
+    float aa = 0;
+    float bb = 0;
+    float ab = 0;
+
+    std::array<float, 4> ax{};
+    std::array<float, 4> bx{};
+
+#ifdef BMFGEN_HAS_SSE2
+    __m128 ax_sum = _mm_setzero_ps();
+    __m128 bx_sum = _mm_setzero_ps();
+#endif
+
+    for (int i = 0; i < 16; ++i)
+    {
+        const float t = float(s_bc7_weights[fit.indices[i]]) / 64.0f;
+        const float s = 1.0f - t;
+
+        aa += s * s;
+        bb += t * t;
+        ab += s * t;
+
+#ifdef BMFGEN_HAS_SSE2
+        const __m128 pixel = load_pixel_ps(block[i]);
+
+        ax_sum = _mm_add_ps(ax_sum, _mm_mul_ps(_mm_set1_ps(s), pixel));
+        bx_sum = _mm_add_ps(bx_sum, _mm_mul_ps(_mm_set1_ps(t), pixel));
+#else
+        for (int c = 0; c < 4; ++c)
+        {
+            ax[c] += s * float(block[i][c]);
+            bx[c] += t * float(block[i][c]);
+        }
+#endif
+    }
+
+#ifdef BMFGEN_HAS_SSE2
+    _mm_storeu_ps(ax.data(), ax_sum);
+    _mm_storeu_ps(bx.data(), bx_sum);
+#endif
+
+    const float determinant = aa * bb - ab * ab;
+
+    if (std::abs(determinant) < 1e-6f)
+    {
+        return std::nullopt;
+    }
+
+    std::array<float, 4> e0{};
+    std::array<float, 4> e1{};
+
+    for (int c = 0; c < 4; ++c)
+    {
+        e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+        e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+    }
+
+    return std::make_pair(e0, e1);
+}
+
+static bool is_uniform(const RgbaBlock& block)
+{
+#ifdef BMFGEN_HAS_SSE2
+    uint32_t first_pixel{};
+    std::memcpy(&first_pixel, block[0].data(), sizeof(first_pixel));
+
+    const auto*   data  = reinterpret_cast<const __m128i*>(block.data());
+    const __m128i first = _mm_set1_epi32(int(first_pixel));
+
+    __m128i equal = _mm_cmpeq_epi32(_mm_loadu_si128(data), first);
+    equal         = _mm_and_si128(equal, _mm_cmpeq_epi32(_mm_loadu_si128(data + 1), first));
+    equal         = _mm_and_si128(equal, _mm_cmpeq_epi32(_mm_loadu_si128(data + 2), first));
+    equal         = _mm_and_si128(equal, _mm_cmpeq_epi32(_mm_loadu_si128(data + 3), first));
+
+    return _mm_movemask_epi8(equal) == 0xFFFF;
+#else
+    return std::all_of(block.begin(), block.end(), [&](const auto& pixel) {
+        return pixel == block[0];
+    });
+#endif
+}
+
+class Bc7BitWriter
+{
+  public:
+    void put(uint64_t value, int count)
+    {
+        const int word = m_position / 64;
+        const int bit  = m_position % 64;
+
+        m_words[word] |= value << bit;
+
+        if (bit + count > 64)
+        {
+            m_words[word + 1] |= value >> (64 - bit);
+        }
+
+        m_position += count;
+    }
+
+    void store(uchar* dst) const
+    {
+        store_u64_le(dst, m_words[0]);
+        store_u64_le(dst + 8, m_words[1]);
+    }
+
+  private:
+    std::array<uint64_t, 2> m_words{};
+    int                     m_position{};
+};
+
+static void encode_bc7_block(const RgbaBlock& block, uchar* dst)
+{
+    Bc7Fit fit;
+
+    if (is_uniform(block))
+    {
+        std::array<float, 4> color{};
+        for (int c = 0; c < 4; ++c)
+        {
+            color[c] = float(block[0][c]);
+        }
+
+        fit = fit_endpoints(block, color, color);
+    }
+    else
+    {
+        const auto [e0, e1] = principal_endpoints(block);
+        fit                 = fit_endpoints(block, e0, e1);
+
+        if (fit.error > 0)
+        {
+            if (const auto refined = refine_endpoints(block, fit))
+            {
+                const Bc7Fit refined_fit = fit_endpoints(block, refined->first, refined->second);
+
+                if (refined_fit.error < fit.error)
+                {
+                    fit = refined_fit;
+                }
+            }
+        }
+    }
+
+    // The most significant index bit of the first pixel is implicitly zero.
+    if (fit.indices[0] >= 8)
+    {
+        std::swap(fit.e0, fit.e1);
+
+        for (int& index : fit.indices)
+        {
+            index = 15 - index;
+        }
+    }
+
+    Bc7BitWriter writer;
+    writer.put(1 << 6, 7); // Mode 6
+
+    for (int c = 0; c < 4; ++c)
+    {
+        writer.put(uint64_t(fit.e0.quantized[c]), 7);
+        writer.put(uint64_t(fit.e1.quantized[c]), 7);
+    }
+
+    writer.put(uint64_t(fit.e0.p_bit), 1);
+    writer.put(uint64_t(fit.e1.p_bit), 1);
+
+    writer.put(uint64_t(fit.indices[0]), 3);
+
+    for (int i = 1; i < 16; ++i)
+    {
+        writer.put(uint64_t(fit.indices[i]), 4);
+    }
+
+    writer.store(dst);
+}
+
+QByteArray BlockCompressor::compress_bc7(const QImage& image)
+{
+    Q_ASSERT(image.format() == QImage::Format_RGBA8888);
+
+    const int blocks_x = (image.width() + 3) / 4;
+
+    return compress_rows(image, BlockFormat::Bc7, [&](int block_y, uchar* dst) {
+        RgbaBlock block{};
+
+        for (int block_x = 0; block_x < blocks_x; ++block_x)
+        {
+            load_block(image,
+                       block_x,
+                       block_y,
+                       block,
+                       [](const uchar* row, int x, std::array<uint8_t, 4>& out) {
+                           std::memcpy(out.data(), row + x * 4, 4);
+                       });
+
+            encode_bc7_block(block, dst + block_x * 16);
+        }
+    });
+}
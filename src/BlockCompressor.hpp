@@ -0,0 +1,36 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <QByteArray>
+
+class QImage;
+
+// GPU block compression formats that pages can be encoded to.
+enum class BlockFormat
+{
+    Bc4, // Single channel, 8 bytes per 4x4 block
+    Bc7, // RGBA, 16 bytes per 4x4 block
+};
+
+// CPU encoders for GPU block-compressed textures.
+// Images are encoded in rows of blocks in parallel. Images whose dimensions are not multiples
+// of 4 are padded by repeating their edge pixels.
+class BlockCompressor final
+{
+  public:
+    BlockCompressor() = delete;
+
+    static int bytes_per_block(BlockFormat format);
+
+    // Returns the size of the compressed data for an image of the specified dimensions.
+    static qsizetype compressed_size(BlockFormat format, int width, int height);
+
+    // Compresses a QImage::Format_Grayscale8 image.
+    static QByteArray compress_bc4(const QImage& image);
+
+    // Compresses a QImage::Format_RGBA8888 (straight alpha) image, using BC7 mode 6.
+    static QByteArray compress_bc7(const QImage& image);
+};
@@ -0,0 +1,104 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "BufferedWriter.hpp"
+
+#include <QIODevice>
+#include <charconv>
+#include <stdexcept>
+
+static constexpr qsizetype buffer_capacity = 64 * 1024;
+
+BufferedWriter::BufferedWriter(QIODevice* device)
+    : m_device(device)
+{
+    m_buffer.reserve(buffer_capacity);
+}
+
+BufferedWriter::~BufferedWriter() noexcept
+{
+    if (!m_buffer.isEmpty())
+    {
+        m_device->write(m_buffer);
+    }
+}
+
+void BufferedWriter::write(char value)
+{
+    m_buffer.append(value);
+    flush_if_full();
+}
+
+void BufferedWriter::write(std::string_view value)
+{
+    m_buffer.append(value.data(), qsizetype(value.size()));
+    flush_if_full();
+}
+
+void BufferedWriter::write(QStringView value)
+{
+    // Descriptors are mostly ASCII, which is copied as-is.
+    qsizetype ascii_count = 0;
+
+    while (ascii_count < value.size() && value[ascii_count].unicode() < 0x80)
+    {
+        m_buffer.append(char(value[ascii_count].unicode()));
+        ++ascii_count;
+    }
+
+    if (ascii_count < value.size())
+    {
+        m_buffer.append(value.sliced(ascii_count).toUtf8());
+    }
+
+    flush_if_full();
+}
+
+void BufferedWriter::write_int(int64_t value)
+{
+    char       chars[24];
+    const auto result = std::to_chars(std::begin(chars), std::end(chars), value);
+    m_buffer.append(chars, result.ptr - chars);
+    flush_if_full();
+}
+
+void BufferedWriter::write_uint(uint64_t value)
+{
+    char       chars[24];
+    const auto result = std::to_chars(std::begin(chars), std::end(chars), value);
+    m_buffer.append(chars, result.ptr - chars);
+    flush_if_full();
+}
+
+void BufferedWriter::write_double(double value)
+{
+    m_buffer.append(QByteArray::number(value, 'g', 6));
+    flush_if_full();
+}
+
+void BufferedWriter::flush()
+{
+    if (m_buffer.isEmpty())
+    {
+        return;
+    }
+
+    if (m_device->write(m_buffer) != m_buffer.size())
+    {
+        throw std::runtime_error(QStringLiteral("Failed to write to device: %1")
+                                     .arg(m_device->errorString())
+                                     .toStdString());
+    }
+
+    // Keeps the capacity.
+    m_buffer.resize(0);
+}
+
+void BufferedWriter::flush_if_full()
+{
+    if (m_buffer.size() >= buffer_capacity)
+    {
+        flush();
+    }
+}
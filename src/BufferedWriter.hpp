@@ -0,0 +1,98 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <QByteArray>
+#include <QStringView>
+#include <concepts>
+#include <cstdint>
+#include <string_view>
+
+class QIODevice;
+
+// Writes UTF-8 text to a device through a fixed-size buffer.
+// Unlike QTextStream, integers are formatted with std::to_chars instead of going through
+// QLocale, which makes it considerably faster for number-heavy output such as descriptors.
+class BufferedWriter final
+{
+  public:
+    explicit BufferedWriter(QIODevice* device);
+
+    BufferedWriter(const BufferedWriter&) = delete;
+
+    void operator=(const BufferedWriter&) = delete;
+
+    // Flushes the remaining buffer; errors are ignored at this point, so call flush()
+    // explicitly to have them reported.
+    ~BufferedWriter() noexcept;
+
+    void write(char value);
+
+    void write(std::string_view value);
+
+    void write(QStringView value);
+
+    void write_int(int64_t value);
+
+    void write_uint(uint64_t value);
+
+    // Formats like QTextStream does by default ('g' with a precision of 6).
+    void write_double(double value);
+
+    // Throws if the device can't be written to.
+    void flush();
+
+    BufferedWriter& operator<<(char value)
+    {
+        write(value);
+        return *this;
+    }
+
+    BufferedWriter& operator<<(const char* value)
+    {
+        write(std::string_view{value});
+        return *this;
+    }
+
+    BufferedWriter& operator<<(const QString& value)
+    {
+        write(QStringView{value});
+        return *this;
+    }
+
+    BufferedWriter& operator<<(QChar value)
+    {
+        write(QStringView{&value, 1});
+        return *this;
+    }
+
+    BufferedWriter& operator<<(double value)
+    {
+        write_double(value);
+        return *this;
+    }
+
+    template <std::integral T>
+        requires(!std::same_as<T, char> && !std::same_as<T, bool>)
+    BufferedWriter& operator<<(T value)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            write_int(value);
+        }
+        else
+        {
+            write_uint(value);
+        }
+
+        return *this;
+    }
+
+  private:
+    void flush_if_full();
+
+    QIODevice* m_device;
+    QByteArray m_buffer;
+};
@@ -4,6 +4,8 @@
 
 #include "CharacterSet.hpp"
 
+#include <algorithm>
+
 QSet<QChar> CharacterSet::chars() const
 {
     Q_ASSERT(range_end <= range_end);
@@ -13,7 +15,12 @@ QSet<QChar> CharacterSet::chars() const
 
     for (uint32_t i = range_start; i <= range_end; ++i)
     {
-        set.insert(QChar(i));
+        const QChar ch(i);
+
+        if (ch.category() != QChar::Other_Control && !ch.isSurrogate())
+        {
+            set.insert(ch);
+        }
     }
 
     return set;
@@ -33,3 +40,316 @@ std::optional<CharacterSet> CharacterSet::find(const QList<CharacterSet>& set_li
 
     return it != set_list.end() ? std::optional{*it} : std::nullopt;
 }
+
+const QList<CharacterSet>& CharacterSet::unicode_blocks()
+{
+    static const QList<CharacterSet> s_blocks{
+        {.name = QStringLiteral("Basic Latin"), .range_start = 0x0000U, .range_end = 0x007FU},
+        {.name        = QStringLiteral("Latin-1 Supplement"),
+         .range_start = 0x0080U,
+         .range_end   = 0x00FFU},
+        {.name = QStringLiteral("Latin Extended-A"), .range_start = 0x0100U, .range_end = 0x017FU},
+        {.name = QStringLiteral("Latin Extended-B"), .range_start = 0x0180U, .range_end = 0x024FU},
+        {.name = QStringLiteral("IPA Extensions"), .range_start = 0x0250U, .range_end = 0x02AFU},
+        {.name        = QStringLiteral("Spacing Modifier Letters"),
+         .range_start = 0x02B0U,
+         .range_end   = 0x02FFU},
+        {.name        = QStringLiteral("Combining Diacritical Marks"),
+         .range_start = 0x0300U,
+         .range_end   = 0x036FU},
+        {.name = QStringLiteral("Greek and Coptic"), .range_start = 0x0370U, .range_end = 0x03FFU},
+        {.name = QStringLiteral("Cyrillic"), .range_start = 0x0400U, .range_end = 0x04FFU},
+        {.name        = QStringLiteral("Cyrillic Supplement"),
+         .range_start = 0x0500U,
+         .range_end   = 0x052FU},
+        {.name = QStringLiteral("Armenian"), .range_start = 0x0530U, .range_end = 0x058FU},
+        {.name = QStringLiteral("Hebrew"), .range_start = 0x0590U, .range_end = 0x05FFU},
+        {.name = QStringLiteral("Arabic"), .range_start = 0x0600U, .range_end = 0x06FFU},
+        {.name = QStringLiteral("Syriac"), .range_start = 0x0700U, .range_end = 0x074FU},
+        {.name = QStringLiteral("Arabic Supplement"), .range_start = 0x0750U, .range_end = 0x077FU},
+        {.name = QStringLiteral("Thaana"), .range_start = 0x0780U, .range_end = 0x07BFU},
+        {.name = QStringLiteral("NKo"), .range_start = 0x07C0U, .range_end = 0x07FFU},
+        {.name = QStringLiteral("Samaritan"), .range_start = 0x0800U, .range_end = 0x083FU},
+        {.name = QStringLiteral("Mandaic"), .range_start = 0x0840U, .range_end = 0x085FU},
+        {.name = QStringLiteral("Syriac Supplement"), .range_start = 0x0860U, .range_end = 0x086FU},
+        {.name = QStringLiteral("Arabic Extended-B"), .range_start = 0x0870U, .range_end = 0x089FU},
+        {.name = QStringLiteral("Arabic Extended-A"), .range_start = 0x08A0U, .range_end = 0x08FFU},
+        {.name = QStringLiteral("Devanagari"), .range_start = 0x0900U, .range_end = 0x097FU},
+        {.name = QStringLiteral("Bengali"), .range_start = 0x0980U, .range_end = 0x09FFU},
+        {.name = QStringLiteral("Gurmukhi"), .range_start = 0x0A00U, .range_end = 0x0A7FU},
+        {.name = QStringLiteral("Gujarati"), .range_start = 0x0A80U, .range_end = 0x0AFFU},
+        {.name = QStringLiteral("Oriya"), .range_start = 0x0B00U, .range_end = 0x0B7FU},
+        {.name = QStringLiteral("Tamil"), .range_start = 0x0B80U, .range_end = 0x0BFFU},
+        {.name = QStringLiteral("Telugu"), .range_start = 0x0C00U, .range_end = 0x0C7FU},
+        {.name = QStringLiteral("Kannada"), .range_start = 0x0C80U, .range_end = 0x0CFFU},
+        {.name = QStringLiteral("Malayalam"), .range_start = 0x0D00U, .range_end = 0x0D7FU},
+        {.name = QStringLiteral("Sinhala"), .range_start = 0x0D80U, .range_end = 0x0DFFU},
+        {.name = QStringLiteral("Thai"), .range_start = 0x0E00U, .range_end = 0x0E7FU},
+        {.name = QStringLiteral("Lao"), .range_start = 0x0E80U, .range_end = 0x0EFFU},
+        {.name = QStringLiteral("Tibetan"), .range_start = 0x0F00U, .range_end = 0x0FFFU},
+        {.name = QStringLiteral("Myanmar"), .range_start = 0x1000U, .range_end = 0x109FU},
+        {.name = QStringLiteral("Georgian"), .range_start = 0x10A0U, .range_end = 0x10FFU},
+        {.name = QStringLiteral("Hangul Jamo"), .range_start = 0x1100U, .range_end = 0x11FFU},
+        {.name = QStringLiteral("Ethiopic"), .range_start = 0x1200U, .range_end = 0x137FU},
+        {.name        = QStringLiteral("Ethiopic Supplement"),
+         .range_start = 0x1380U,
+         .range_end   = 0x139FU},
+        {.name = QStringLiteral("Cherokee"), .range_start = 0x13A0U, .range_end = 0x13FFU},
+        {.name        = QStringLiteral("Unified Canadian Aboriginal Syllabics"),
+         .range_start = 0x1400U,
+         .range_end   = 0x167FU},
+        {.name = QStringLiteral("Ogham"), .range_start = 0x1680U, .range_end = 0x169FU},
+        {.name = QStringLiteral("Runic"), .range_start = 0x16A0U, .range_end = 0x16FFU},
+        {.name = QStringLiteral("Tagalog"), .range_start = 0x1700U, .range_end = 0x171FU},
+        {.name = QStringLiteral("Hanunoo"), .range_start = 0x1720U, .range_end = 0x173FU},
+        {.name = QStringLiteral("Buhid"), .range_start = 0x1740U, .range_end = 0x175FU},
+        {.name = QStringLiteral("Tagbanwa"), .range_start = 0x1760U, .range_end = 0x177FU},
+        {.name = QStringLiteral("Khmer"), .range_start = 0x1780U, .range_end = 0x17FFU},
+        {.name = QStringLiteral("Mongolian"), .range_start = 0x1800U, .range_end = 0x18AFU},
+        {.name        = QStringLiteral("Unified Canadian Aboriginal Syllabics Extended"),
+         .range_start = 0x18B0U,
+         .range_end   = 0x18FFU},
+        {.name = QStringLiteral("Limbu"), .range_start = 0x1900U, .range_end = 0x194FU},
+        {.name = QStringLiteral("Tai Le"), .range_start = 0x1950U, .range_end = 0x197FU},
+        {.name = QStringLiteral("New Tai Lue"), .range_start = 0x1980U, .range_end = 0x19DFU},
+        {.name = QStringLiteral("Khmer Symbols"), .range_start = 0x19E0U, .range_end = 0x19FFU},
+        {.name = QStringLiteral("Buginese"), .range_start = 0x1A00U, .range_end = 0x1A1FU},
+        {.name = QStringLiteral("Tai Tham"), .range_start = 0x1A20U, .range_end = 0x1AAFU},
+        {.name        = QStringLiteral("Combining Diacritical Marks Extended"),
+         .range_start = 0x1AB0U,
+         .range_end   = 0x1AFFU},
+        {.name = QStringLiteral("Balinese"), .range_start = 0x1B00U, .range_end = 0x1B7FU},
+        {.name = QStringLiteral("Sundanese"), .range_start = 0x1B80U, .range_end = 0x1BBFU},
+        {.name = QStringLiteral("Batak"), .range_start = 0x1BC0U, .range_end = 0x1BFFU},
+        {.name = QStringLiteral("Lepcha"), .range_start = 0x1C00U, .range_end = 0x1C4FU},
+        {.name = QStringLiteral("Ol Chiki"), .range_start = 0x1C50U, .range_end = 0x1C7FU},
+        {.name        = QStringLiteral("Cyrillic Extended-C"),
+         .range_start = 0x1C80U,
+         .range_end   = 0x1C8FU},
+        {.name = QStringLiteral("Georgian Extended"), .range_start = 0x1C90U, .range_end = 0x1CBFU},
+        {.name        = QStringLiteral("Sundanese Supplement"),
+         .range_start = 0x1CC0U,
+         .range_end   = 0x1CCFU},
+        {.name = QStringLiteral("Vedic Extensions"), .range_start = 0x1CD0U, .range_end = 0x1CFFU},
+        {.name        = QStringLiteral("Phonetic Extensions"),
+         .range_start = 0x1D00U,
+         .range_end   = 0x1D7FU},
+        {.name        = QStringLiteral("Phonetic Extensions Supplement"),
+         .range_start = 0x1D80U,
+         .range_end   = 0x1DBFU},
+        {.name        = QStringLiteral("Combining Diacritical Marks Supplement"),
+         .range_start = 0x1DC0U,
+         .range_end   = 0x1DFFU},
+        {.name        = QStringLiteral("Latin Extended Additional"),
+         .range_start = 0x1E00U,
+         .range_end   = 0x1EFFU},
+        {.name = QStringLiteral("Greek Extended"), .range_start = 0x1F00U, .range_end = 0x1FFFU},
+        {.name        = QStringLiteral("General Punctuation"),
+         .range_start = 0x2000U,
+         .range_end   = 0x206FU},
+        {.name        = QStringLiteral("Superscripts and Subscripts"),
+         .range_start = 0x2070U,
+         .range_end   = 0x209FU},
+        {.name = QStringLiteral("Currency Symbols"), .range_start = 0x20A0U, .range_end = 0x20CFU},
+        {.name        = QStringLiteral("Combining Diacritical Marks for Symbols"),
+         .range_start = 0x20D0U,
+         .range_end   = 0x20FFU},
+        {.name        = QStringLiteral("Letterlike Symbols"),
+         .range_start = 0x2100U,
+         .range_end   = 0x214FU},
+        {.name = QStringLiteral("Number Forms"), .range_start = 0x2150U, .range_end = 0x218FU},
+        {.name = QStringLiteral("Arrows"), .range_start = 0x2190U, .range_end = 0x21FFU},
+        {.name        = QStringLiteral("Mathematical Operators"),
+         .range_start = 0x2200U,
+         .range_end   = 0x22FFU},
+        {.name        = QStringLiteral("Miscellaneous Technical"),
+         .range_start = 0x2300U,
+         .range_end   = 0x23FFU},
+        {.name = QStringLiteral("Control Pictures"), .range_start = 0x2400U, .range_end = 0x243FU},
+        {.name        = QStringLiteral("Optical Character Recognition"),
+         .range_start = 0x2440U,
+         .range_end   = 0x245FU},
+        {.name        = QStringLiteral("Enclosed Alphanumerics"),
+         .range_start = 0x2460U,
+         .range_end   = 0x24FFU},
+        {.name = QStringLiteral("Box Drawing"), .range_start = 0x2500U, .range_end = 0x257FU},
+        {.name = QStringLiteral("Block Elements"), .range_start = 0x2580U, .range_end = 0x259FU},
+        {.name = QStringLiteral("Geometric Shapes"), .range_start = 0x25A0U, .range_end = 0x25FFU},
+        {.name        = QStringLiteral("Miscellaneous Symbols"),
+         .range_start = 0x2600U,
+         .range_end   = 0x26FFU},
+        {.name = QStringLiteral("Dingbats"), .range_start = 0x2700U, .range_end = 0x27BFU},
+        {.name        = QStringLiteral("Miscellaneous Mathematical Symbols-A"),
+         .range_start = 0x27C0U,
+         .range_end   = 0x27EFU},
+        {.name        = QStringLiteral("Supplemental Arrows-A"),
+         .range_start = 0x27F0U,
+         .range_end   = 0x27FFU},
+        {.name = QStringLiteral("Braille Patterns"), .range_start = 0x2800U, .range_end = 0x28FFU},
+        {.name        = QStringLiteral("Supplemental Arrows-B"),
+         .range_start = 0x2900U,
+         .range_end   = 0x297FU},
+        {.name        = QStringLiteral("Miscellaneous Mathematical Symbols-B"),
+         .range_start = 0x2980U,
+         .range_end   = 0x29FFU},
+        {.name        = QStringLiteral("Supplemental Mathematical Operators"),
+         .range_start = 0x2A00U,
+         .range_end   = 0x2AFFU},
+        {.name        = QStringLiteral("Miscellaneous Symbols and Arrows"),
+         .range_start = 0x2B00U,
+         .range_end   = 0x2BFFU},
+        {.name = QStringLiteral("Glagolitic"), .range_start = 0x2C00U, .range_end = 0x2C5FU},
+        {.name = QStringLiteral("Latin Extended-C"), .range_start = 0x2C60U, .range_end = 0x2C7FU},
+        {.name = QStringLiteral("Coptic"), .range_start = 0x2C80U, .range_end = 0x2CFFU},
+        {.name        = QStringLiteral("Georgian Supplement"),
+         .range_start = 0x2D00U,
+         .range_end   = 0x2D2FU},
+        {.name = QStringLiteral("Tifinagh"), .range_start = 0x2D30U, .range_end = 0x2D7FU},
+        {.name = QStringLiteral("Ethiopic Extended"), .range_start = 0x2D80U, .range_end = 0x2DDFU},
+        {.name        = QStringLiteral("Cyrillic Extended-A"),
+         .range_start = 0x2DE0U,
+         .range_end   = 0x2DFFU},
+        {.name        = QStringLiteral("Supplemental Punctuation"),
+         .range_start = 0x2E00U,
+         .range_end   = 0x2E7FU},
+        {.name        = QStringLiteral("CJK Radicals Supplement"),
+         .range_start = 0x2E80U,
+         .range_end   = 0x2EFFU},
+        {.name = QStringLiteral("Kangxi Radicals"), .range_start = 0x2F00U, .range_end = 0x2FDFU},
+        {.name        = QStringLiteral("Ideographic Description Characters"),
+         .range_start = 0x2FF0U,
+         .range_end   = 0x2FFFU},
+        {.name        = QStringLiteral("CJK Symbols and Punctuation"),
+         .range_start = 0x3000U,
+         .range_end   = 0x303FU},
+        {.name = QStringLiteral("Hiragana"), .range_start = 0x3040U, .range_end = 0x309FU},
+        {.name = QStringLiteral("Katakana"), .range_start = 0x30A0U, .range_end = 0x30FFU},
+        {.name = QStringLiteral("Bopomofo"), .range_start = 0x3100U, .range_end = 0x312FU},
+        {.name        = QStringLiteral("Hangul Compatibility Jamo"),
+         .range_start = 0x3130U,
+         .range_end   = 0x318FU},
+        {.name = QStringLiteral("Kanbun"), .range_start = 0x3190U, .range_end = 0x319FU},
+        {.name = QStringLiteral("Bopomofo Extended"), .range_start = 0x31A0U, .range_end = 0x31BFU},
+        {.name = QStringLiteral("CJK Strokes"), .range_start = 0x31C0U, .range_end = 0x31EFU},
+        {.name        = QStringLiteral("Katakana Phonetic Extensions"),
+         .range_start = 0x31F0U,
+         .range_end   = 0x31FFU},
+        {.name        = QStringLiteral("Enclosed CJK Letters and Months"),
+         .range_start = 0x3200U,
+         .range_end   = 0x32FFU},
+        {.name = QStringLiteral("CJK Compatibility"), .range_start = 0x3300U, .range_end = 0x33FFU},
+        {.name        = QStringLiteral("CJK Unified Ideographs Extension A"),
+         .range_start = 0x3400U,
+         .range_end   = 0x4DBFU},
+        {.name        = QStringLiteral("Yijing Hexagram Symbols"),
+         .range_start = 0x4DC0U,
+         .range_end   = 0x4DFFU},
+        {.name        = QStringLiteral("CJK Unified Ideographs"),
+         .range_start = 0x4E00U,
+         .range_end   = 0x9FFFU},
+        {.name = QStringLiteral("Yi Syllables"), .range_start = 0xA000U, .range_end = 0xA48FU},
+        {.name = QStringLiteral("Yi Radicals"), .range_start = 0xA490U, .range_end = 0xA4CFU},
+        {.name = QStringLiteral("Lisu"), .range_start = 0xA4D0U, .range_end = 0xA4FFU},
+        {.name = QStringLiteral("Vai"), .range_start = 0xA500U, .range_end = 0xA63FU},
+        {.name        = QStringLiteral("Cyrillic Extended-B"),
+         .range_start = 0xA640U,
+         .range_end   = 0xA69FU},
+        {.name = QStringLiteral("Bamum"), .range_start = 0xA6A0U, .range_end = 0xA6FFU},
+        {.name        = QStringLiteral("Modifier Tone Letters"),
+         .range_start = 0xA700U,
+         .range_end   = 0xA71FU},
+        {.name = QStringLiteral("Latin Extended-D"), .range_start = 0xA720U, .range_end = 0xA7FFU},
+        {.name = QStringLiteral("Syloti Nagri"), .range_start = 0xA800U, .range_end = 0xA82FU},
+        {.name        = QStringLiteral("Common Indic Number Forms"),
+         .range_start = 0xA830U,
+         .range_end   = 0xA83FU},
+        {.name = QStringLiteral("Phags-pa"), .range_start = 0xA840U, .range_end = 0xA87FU},
+        {.name = QStringLiteral("Saurashtra"), .range_start = 0xA880U, .range_end = 0xA8DFU},
+        {.name        = QStringLiteral("Devanagari Extended"),
+         .range_start = 0xA8E0U,
+         .range_end   = 0xA8FFU},
+        {.name = QStringLiteral("Kayah Li"), .range_start = 0xA900U, .range_end = 0xA92FU},
+        {.name = QStringLiteral("Rejang"), .range_start = 0xA930U, .range_end = 0xA95FU},
+        {.name        = QStringLiteral("Hangul Jamo Extended-A"),
+         .range_start = 0xA960U,
+         .range_end   = 0xA97FU},
+        {.name = QStringLiteral("Javanese"), .range_start = 0xA980U, .range_end = 0xA9DFU},
+        {.name        = QStringLiteral("Myanmar Extended-B"),
+         .range_start = 0xA9E0U,
+         .range_end   = 0xA9FFU},
+        {.name = QStringLiteral("Cham"), .range_start = 0xAA00U, .range_end = 0xAA5FU},
+        {.name        = QStringLiteral("Myanmar Extended-A"),
+         .range_start = 0xAA60U,
+         .range_end   = 0xAA7FU},
+        {.name = QStringLiteral("Tai Viet"), .range_start = 0xAA80U, .range_end = 0xAADFU},
+        {.name        = QStringLiteral("Meetei Mayek Extensions"),
+         .range_start = 0xAAE0U,
+         .range_end   = 0xAAFFU},
+        {.name        = QStringLiteral("Ethiopic Extended-A"),
+         .range_start = 0xAB00U,
+         .range_end   = 0xAB2FU},
+        {.name = QStringLiteral("Latin Extended-E"), .range_start = 0xAB30U, .range_end = 0xAB6FU},
+        {.name        = QStringLiteral("Cherokee Supplement"),
+         .range_start = 0xAB70U,
+         .range_end   = 0xABBFU},
+        {.name = QStringLiteral("Meetei Mayek"), .range_start = 0xABC0U, .range_end = 0xABFFU},
+        {.name = QStringLiteral("Hangul Syllables"), .range_start = 0xAC00U, .range_end = 0xD7AFU},
+        {.name        = QStringLiteral("Hangul Jamo Extended-B"),
+         .range_start = 0xD7B0U,
+         .range_end   = 0xD7FFU},
+        {.name = QStringLiteral("High Surrogates"), .range_start = 0xD800U, .range_end = 0xDB7FU},
+        {.name        = QStringLiteral("High Private Use Surrogates"),
+         .range_start = 0xDB80U,
+         .range_end   = 0xDBFFU},
+        {.name = QStringLiteral("Low Surrogates"), .range_start = 0xDC00U, .range_end = 0xDFFFU},
+        {.name = QStringLiteral("Private Use Area"), .range_start = 0xE000U, .range_end = 0xF8FFU},
+        {.name        = QStringLiteral("CJK Compatibility Ideographs"),
+         .range_start = 0xF900U,
+         .range_end   = 0xFAFFU},
+        {.name        = QStringLiteral("Alphabetic Presentation Forms"),
+         .range_start = 0xFB00U,
+         .range_end   = 0xFB4FU},
+        {.name        = QStringLiteral("Arabic Presentation Forms-A"),
+         .range_start = 0xFB50U,
+         .range_end   = 0xFDFFU},
+        {.name        = QStringLiteral("Variation Selectors"),
+         .range_start = 0xFE00U,
+         .range_end   = 0xFE0FU},
+        {.name = QStringLiteral("Vertical Forms"), .range_start = 0xFE10U, .range_end = 0xFE1FU},
+        {.name        = QStringLiteral("Combining Half Marks"),
+         .range_start = 0xFE20U,
+         .range_end   = 0xFE2FU},
+        {.name        = QStringLiteral("CJK Compatibility Forms"),
+         .range_start = 0xFE30U,
+         .range_end   = 0xFE4FU},
+        {.name        = QStringLiteral("Small Form Variants"),
+         .range_start = 0xFE50U,
+         .range_end   = 0xFE6FU},
+        {.name        = QStringLiteral("Arabic Presentation Forms-B"),
+         .range_start = 0xFE70U,
+         .range_end   = 0xFEFFU},
+        {.name        = QStringLiteral("Halfwidth and Fullwidth Forms"),
+         .range_start = 0xFF00U,
+         .range_end   = 0xFFEFU},
+        {.name = QStringLiteral("Specials"), .range_start = 0xFFF0U, .range_end = 0xFFFFU},
+    };
+
+    return s_blocks;
+}
+
+const CharacterSet* CharacterSet::find_unicode_block(QChar ch)
+{
+    const QList<CharacterSet>& blocks = unicode_blocks();
+    const uint32_t             code   = ch.unicode();
+
+    const auto it = std::ranges::upper_bound(blocks, code, {}, &CharacterSet::range_start);
+
+    if (it == blocks.begin())
+    {
+        return nullptr;
+    }
+
+    const CharacterSet& block = *std::prev(it);
+
+    return code <= block.range_end ? &block : nullptr;
+}
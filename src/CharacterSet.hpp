@@ -14,6 +14,8 @@ class CharacterSet
     uint32_t range_start;
     uint32_t range_end;
 
+    // Returns the characters of the range, except for control characters and surrogates,
+    // which have no glyphs of their own.
     QSet<QChar> chars() const;
 
     qsizetype count() const;
@@ -21,6 +23,12 @@ class CharacterSet
     static std::optional<CharacterSet> find(const QList<CharacterSet>& set_list,
                                             const QString&             name);
 
+    // The Unicode blocks of the Basic Multilingual Plane, sorted by their first code point.
+    // Used for page grouping and as the character sets offered in the character set dialog.
+    static const QList<CharacterSet>& unicode_blocks();
+
+    static const CharacterSet* find_unicode_block(QChar ch);
+
     bool operator==(const CharacterSet&) const = default;
 
     bool operator!=(const CharacterSet&) const = default;
@@ -0,0 +1,100 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "ExportManifest.hpp"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <stdexcept>
+
+static constexpr int manifest_version = 1;
+
+ExportManifest::ExportManifest(const QString& filename)
+    : m_filename(filename)
+{
+    QFile file{filename};
+
+    if (!file.open(QFile::ReadOnly))
+    {
+        return;
+    }
+
+    m_previous_contents = file.readAll();
+
+    const QJsonObject root_obj = QJsonDocument::fromJson(m_previous_contents).object();
+
+    if (root_obj.value(QStringLiteral("version")).toInt() != manifest_version)
+    {
+        qDebug("Ignoring incompatible export manifest '%s'", qPrintable(filename));
+        return;
+    }
+
+    const QJsonObject files_obj = root_obj.value(QStringLiteral("files")).toObject();
+
+    for (auto it = files_obj.begin(); it != files_obj.end(); ++it)
+    {
+        m_previous_keys.insert(it.key(), it.value().toString().toLatin1());
+    }
+}
+
+bool ExportManifest::update(const QString& filename, const QByteArray& key)
+{
+    const QString name = QFileInfo{filename}.fileName();
+
+    QMutexLocker lock{&m_mutex};
+
+    m_keys.insert(name, key);
+
+    return m_previous_keys.value(name) != key || !QFileInfo::exists(filename);
+}
+
+void ExportManifest::set_cache_key(uint64_t value)
+{
+    m_cache_key = value;
+}
+
+void ExportManifest::save() const
+{
+    QJsonObject files_obj;
+
+    {
+        QMutexLocker lock{&m_mutex};
+
+        for (auto it = m_keys.begin(); it != m_keys.end(); ++it)
+        {
+            files_obj.insert(it.key(), QString::fromLatin1(it.value()));
+        }
+    }
+
+    QJsonObject root_obj;
+    root_obj.insert(QStringLiteral("version"), manifest_version);
+    root_obj.insert(QStringLiteral("cacheKey"), QString::number(m_cache_key, 16));
+    root_obj.insert(QStringLiteral("files"), files_obj);
+
+    const QByteArray contents = QJsonDocument{root_obj}.toJson();
+
+    if (contents == m_previous_contents)
+    {
+        return;
+    }
+
+    QFile file{m_filename};
+
+    if (!file.open(QFile::WriteOnly) || file.write(contents) != contents.size())
+    {
+        throw std::runtime_error(QStringLiteral("Failed to write export manifest '%1'.")
+                                     .arg(m_filename)
+                                     .toStdString());
+    }
+}
+
+QByteArray ExportManifest::hash(QByteArrayView data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex();
+}
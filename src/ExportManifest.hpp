@@ -0,0 +1,49 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <cstdint>
+
+// Records a key for every file that an export produces, so that subsequent exports into the
+// same directory only rewrite files whose key changed. The key of a file is a hash of either
+// its contents or of everything it is generated from.
+//
+// The manifest is stored next to the exported files as JSON:
+//   { "version": 1, "cacheKey": "<hex>", "files": { "<file name>": "<hex key>", ... } }
+// so that external build systems can track changes as well.
+class ExportManifest final
+{
+  public:
+    // Loads the manifest of a previous export. A missing or invalid manifest is treated as
+    // empty, i.e. every file is considered changed.
+    explicit ExportManifest(const QString& filename);
+
+    // Records the key of a file and returns whether the file has to be (re)written, which is
+    // the case if the key differs from the previous export or the file doesn't exist.
+    // File names are stored relative to the manifest's directory. Thread-safe.
+    bool update(const QString& filename, const QByteArray& key);
+
+    // A coarse fingerprint of the exported font's structure.
+    void set_cache_key(uint64_t value);
+
+    // Writes the manifest, unless it is identical to the previous one.
+    // Throws if the manifest can't be written.
+    void save() const;
+
+    // Returns the hex-encoded MD5 hash of data.
+    static QByteArray hash(QByteArrayView data);
+
+  private:
+    QString                    m_filename;
+    QByteArray                 m_previous_contents;
+    QHash<QString, QByteArray> m_previous_keys;
+    QHash<QString, QByteArray> m_keys;
+    uint64_t                   m_cache_key{};
+    mutable QMutex             m_mutex;
+};
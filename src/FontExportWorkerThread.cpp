@@ -0,0 +1,78 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FontExportWorkerThread.hpp"
+
+#include "FontGenContext.hpp"
+#include "FontModel.hpp"
+
+FontExportWorkerThread::FontExportWorkerThread(const FontModel*         model,
+                                               FontGenContext*          context,
+                                               const QString&           output_directory,
+                                               const FontExportOptions& options)
+    : QThread(nullptr)
+    , m_model(model)
+    , m_context(context)
+    , m_output_directory(output_directory)
+    , m_options(options)
+{
+}
+
+void FontExportWorkerThread::run()
+{
+    const FontExportProgress progress{
+        .on_progress =
+            [this](FontExportStage stage, int completed, int total) {
+                const QMutexLocker lock{&m_progress_mutex};
+
+                // Pages that are encoded concurrently may report their counts out of order.
+                if (stage == m_last_reported_stage && completed < m_last_reported_count)
+                {
+                    return;
+                }
+
+                m_last_reported_stage = stage;
+                m_last_reported_count = completed;
+
+                emit progress_changed(stage, completed, total);
+            },
+        .cancel_requested = [this] { return m_is_canceled.load(); },
+    };
+
+    try
+    {
+        progress.report(FontExportStage::Generating, 0, 1);
+
+        const std::shared_ptr<GeneratedFont> generated_font =
+            m_context->generate_font(*m_model, {});
+
+        progress.throw_if_canceled();
+        progress.report(FontExportStage::Generating, 1, 1);
+
+        generated_font->export_to_disk(m_output_directory, m_options, progress);
+
+        emit export_succeeded();
+    }
+    catch (const GenerationCanceledError&)
+    {
+        qDebug("Font export canceled during generation");
+        emit export_canceled();
+    }
+    catch (const ExportCanceledError&)
+    {
+        qDebug("Font export canceled");
+        emit export_canceled();
+    }
+    catch (const std::exception& ex)
+    {
+        qCritical("Font export failed: %s", ex.what());
+        emit export_failed(QString::fromUtf8(ex.what()));
+    }
+}
+
+void FontExportWorkerThread::cancel()
+{
+    m_is_canceled = true;
+    m_context->cancel();
+}
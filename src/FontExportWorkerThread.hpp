@@ -0,0 +1,53 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include "GeneratedFont.hpp"
+#include <QMutex>
+#include <QThread>
+#include <atomic>
+
+class FontModel;
+class FontGenContext;
+
+// Generates a font and exports it to disk, so that encoding and writing files never blocks
+// the GUI thread. Exactly one of export_succeeded(), export_failed() and export_canceled() is
+// emitted before the thread finishes.
+class FontExportWorkerThread : public QThread
+{
+    Q_OBJECT
+
+  public:
+    explicit FontExportWorkerThread(const FontModel*         model,
+                                    FontGenContext*          context,
+                                    const QString&           output_directory,
+                                    const FontExportOptions& options);
+
+    void run() override;
+
+    // Can be called from any thread.
+    void cancel();
+
+  signals:
+    // Emitted from worker threads, one at a time and with increasing completed counts per stage.
+    // Stages run in the order of FontExportStage.
+    void progress_changed(FontExportStage stage, int completed, int total);
+
+    void export_succeeded();
+
+    void export_failed(const QString& message);
+
+    void export_canceled();
+
+  private:
+    const FontModel*  m_model;
+    FontGenContext*   m_context;
+    QString           m_output_directory;
+    FontExportOptions m_options;
+    std::atomic<bool> m_is_canceled{};
+    QMutex            m_progress_mutex;
+    FontExportStage   m_last_reported_stage{};
+    int               m_last_reported_count{-1};
+};
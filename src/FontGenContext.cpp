@@ -9,11 +9,18 @@
 #include "ImageCache.hpp"
 #include "MaxRectsBinPack.hpp"
 #include <QFile>
+#include <QFileInfo>
 #include <QPainterPath>
+#include <QRawFont>
 #include <QStaticText>
 #include <QTextItem>
+#include <QTextStream>
+#include <QtConcurrentMap>
+#include <algorithm>
 #include <array>
+#include <cstring>
 #include <optional>
+#include <vector>
 
 static std::pair<bool, float> can_fit_all_glyphs(
     const QList<Glyph>&                                  all_glyphs,
@@ -87,16 +94,10 @@ qsizetype FontGenContext::insert_as_many_glyphs_as_possible(
     return num_inserted_glyphs;
 }
 
-std::optional<QList<FontPage>> FontGenContext::pack_glyphs(QList<Glyph>& glyphs, int max_page_size)
+std::optional<QList<FontPage>> FontGenContext::pack_glyphs(QList<Glyph>&    glyphs,
+                                                           QList<qsizetype> glyphs_to_insert,
+                                                           int              max_page_size)
 {
-    QList<qsizetype> glyphs_to_insert;
-    glyphs_to_insert.reserve(glyphs.size());
-
-    for (qsizetype i = 0; i < glyphs.size(); ++i)
-    {
-        glyphs_to_insert.push_back(i);
-    }
-
     auto bin_size = QSize(32, 32);
 
     using Heuristic = binpacking::MaxRectsBinPack::FreeRectChoiceHeuristic;
@@ -110,6 +111,20 @@ std::optional<QList<FontPage>> FontGenContext::pack_glyphs(QList<Glyph>& glyphs,
 
     auto pages = QList<FontPage>();
 
+    // Adds a finished page to the packing progress.
+    const auto report_page = [&](const FontPage& page) {
+        for (const qsizetype glyph_index : page.glyph_indices)
+        {
+            const QRect& rect = glyphs[glyph_index].rect;
+            m_packed_glyph_area += qint64(rect.width()) * rect.height();
+        }
+
+        m_packed_page_area += qint64(page.image.width()) * page.image.height();
+        m_progress.occupancy = float(double(m_packed_glyph_area) / double(m_packed_page_area));
+
+        report_progress(m_progress.completed + page.glyph_indices.size());
+    };
+
     while (!glyphs_to_insert.empty())
     {
         if (m_is_canceled)
@@ -145,6 +160,8 @@ std::optional<QList<FontPage>> FontGenContext::pack_glyphs(QList<Glyph>& glyphs,
                     return {};
                 }
 
+                report_page(pages.back());
+
                 break;
             }
 
@@ -186,51 +203,285 @@ std::optional<QList<FontPage>> FontGenContext::pack_glyphs(QList<Glyph>& glyphs,
                 return std::optional<QList<FontPage>>();
             }
 
+            report_page(pages.back());
+
             bin_size = QSize(32, 32);
         }
     }
 
-    for (int p = 0; p < pages.size(); ++p)
+    return pages;
+}
+
+// Checks that every glyph lies within its page and that no two glyphs of a page overlap.
+// Always performed in debug builds; release builds perform it when BMFGEN_VERIFY_ATLAS is set.
+static void verify_pages(const QList<Glyph>& all_glyphs, const QList<FontPage>& pages)
+{
+    QList<QRect> rects;
+
+    for (qsizetype p = 0; p < pages.size(); ++p)
     {
-        const FontPage& page = pages[p];
+        const FontPage& page      = pages[p];
+        const QRect     page_rect = QRect{QPoint{}, page.image.size()};
+
+        rects.clear();
+        rects.reserve(page.glyph_indices.size());
 
         for (const qsizetype glyph_index : page.glyph_indices)
         {
-            Glyph& glyph     = glyphs[glyph_index];
-            glyph.page_index = p;
+            const Glyph& glyph = all_glyphs[glyph_index];
+
+            if (glyph.page_index != p)
+            {
+                qCritical("Glyph %lld belongs to page %d but is listed on page %lld",
+                          qlonglong(glyph_index),
+                          glyph.page_index,
+                          qlonglong(p));
+                throw AtlasVerificationError();
+            }
+
+            if (!glyph.rect.isEmpty() && !page_rect.contains(glyph.rect))
+            {
+                qCritical("Glyph %lld is out of bounds of page %lld",
+                          qlonglong(glyph_index),
+                          qlonglong(p));
+                throw AtlasVerificationError();
+            }
+
+            rects.push_back(glyph.rect);
         }
-    }
 
-    return pages;
+        if (const auto overlap = binpacking::find_overlapping_rects(rects))
+        {
+            qCritical("Glyphs %lld and %lld overlap on page %lld",
+                      qlonglong(page.glyph_indices[overlap->first]),
+                      qlonglong(page.glyph_indices[overlap->second]),
+                      qlonglong(p));
+            throw AtlasVerificationError();
+        }
+    }
 }
 
 static void MoveGlyphDataToTheirPages(const QList<Glyph>& all_glyphs, QList<FontPage>& pages)
 {
+    // Packed glyphs never overlap and pages start out fully transparent, so instead of blending
+    // the glyph images, their rows are copied directly. Pages are split into horizontal bands
+    // that are composited in parallel.
+    constexpr int band_height = 256;
+
+    struct Band
+    {
+        const FontPage* page;
+        uchar*          bits;
+        int             y_begin;
+        int             y_end;
+    };
+
+    QList<Band> bands;
+
     for (FontPage& page : pages)
     {
-        QPainter painter{&page.image};
+        // Detach the page's image before its bits are shared among multiple threads.
+        uchar*    bits   = page.image.bits();
+        const int height = page.image.height();
 
-        for (const qsizetype glyph_index : page.glyph_indices)
+        for (int y = 0; y < height; y += band_height)
         {
-            const auto& glyph = all_glyphs[glyph_index];
-            painter.drawImage(glyph.rect.topLeft(), glyph.image);
+            bands.push_back(Band{
+                .page    = &page,
+                .bits    = bits,
+                .y_begin = y,
+                .y_end   = std::min(y + band_height, height),
+            });
         }
     }
+
+    QtConcurrent::blockingMap(bands, [&all_glyphs](const Band& band) {
+        const QImage&   page_image      = band.page->image;
+        const qsizetype bytes_per_line  = page_image.bytesPerLine();
+        const int       bytes_per_pixel = page_image.depth() / 8;
+
+        for (const qsizetype glyph_index : band.page->glyph_indices)
+        {
+            const Glyph& glyph = all_glyphs[glyph_index];
+            const QRect& rect  = glyph.rect;
+
+            const int y_begin = std::max(rect.y(), band.y_begin);
+            const int y_end   = std::min(rect.y() + std::min(rect.height(), glyph.image.height()),
+                                       band.y_end);
+
+            if (y_begin >= y_end)
+            {
+                continue;
+            }
+
+            Q_ASSERT(glyph.image.format() == page_image.format());
+
+            const qsizetype row_size =
+                qsizetype(std::min(rect.width(), glyph.image.width())) * bytes_per_pixel;
+
+            uchar* dst = band.bits + y_begin * bytes_per_line + rect.x() * bytes_per_pixel;
+
+            for (int y = y_begin; y < y_end; ++y)
+            {
+                std::memcpy(dst, glyph.image.constScanLine(y - rect.y()), row_size);
+                dst += bytes_per_line;
+            }
+        }
+    });
 }
 
-std::optional<QList<FontPage>> FontGenContext::create_font_pages(QList<Glyph>& glyphs,
-                                                                 int           max_page_extent)
+static QList<PageGroup> build_page_groups(const FontModel& font)
 {
-    auto maybe_pages = pack_glyphs(glyphs, max_page_extent);
+    if (font.page_grouping() == PageGrouping::UnicodeBlocks)
+    {
+        QList<PageGroup> groups;
+        groups.reserve(CharacterSet::unicode_blocks().size());
+
+        for (const CharacterSet& block : CharacterSet::unicode_blocks())
+        {
+            groups.append(PageGroup{
+                .name   = block.name,
+                .ranges = {{.first = block.range_start, .last = block.range_end}},
+            });
+        }
 
-    if (!maybe_pages.has_value())
+        return groups;
+    }
+
+    if (font.page_grouping() == PageGrouping::Custom)
     {
-        return {};
+        std::optional<QList<PageGroup>> groups = PageGroup::parse_list(font.page_groups());
+
+        if (!groups)
+        {
+            throw InvalidPageGroupsError();
+        }
+
+        return std::move(*groups);
     }
 
-    auto pages = std::move(*maybe_pages);
+    return {};
+}
+
+static qsizetype find_page_group_index(const QList<PageGroup>& groups,
+                                       PageGrouping            grouping,
+                                       QChar                   ch)
+{
+    if (grouping == PageGrouping::UnicodeBlocks)
+    {
+        // The groups mirror the sorted block list, so the lookup can be done by position.
+        const CharacterSet* block = CharacterSet::find_unicode_block(ch);
+
+        return block != nullptr ? std::distance(CharacterSet::unicode_blocks().data(), block)
+                                : groups.size();
+    }
+
+    for (qsizetype i = 0; i < groups.size(); ++i)
+    {
+        if (groups[i].contains(ch))
+        {
+            return i;
+        }
+    }
+
+    return groups.size();
+}
+
+std::optional<QList<FontPage>> FontGenContext::create_font_pages(QList<Glyph>&     glyphs,
+                                                                 int               max_page_extent,
+                                                                 PageGrouping      grouping,
+                                                                 QList<PageGroup>& page_groups)
+{
+    // Distribute the glyphs among their groups. Glyphs that don't belong to any group end up
+    // in a trailing, implicit group.
+    QList<QList<qsizetype>> glyphs_per_group(page_groups.size() + 1);
+
+    for (qsizetype i = 0; i < glyphs.size(); ++i)
+    {
+        const qsizetype group_index =
+            grouping == PageGrouping::None
+                ? page_groups.size()
+                : find_page_group_index(page_groups, grouping, glyphs[i].character);
+
+        glyphs_per_group[group_index].push_back(i);
+    }
+
+    if (!glyphs_per_group.back().isEmpty() && grouping != PageGrouping::None)
+    {
+        page_groups.append(PageGroup{.name = QStringLiteral("Other")});
+    }
+
+    // Glyphs are inserted from the back of each list. Ordering them by their frequency rank
+    // places the most frequent glyphs together on the first page of their group. Glyphs that
+    // don't appear in the corpus are inserted last.
+    const auto frequency_key = [&glyphs](qsizetype glyph_index) {
+        const int rank = glyphs[glyph_index].frequency_rank;
+        return rank < 0 ? std::numeric_limits<int>::max() : rank;
+    };
+
+    for (QList<qsizetype>& glyph_indices : glyphs_per_group)
+    {
+        std::ranges::stable_sort(glyph_indices, [&](qsizetype lhs, qsizetype rhs) {
+            return frequency_key(lhs) > frequency_key(rhs);
+        });
+    }
+
+    QList<FontPage>  pages;
+    QList<PageGroup> used_page_groups;
+
+    begin_stage(FontGenStage::Packing, glyphs.size());
+    m_packed_glyph_area = 0;
+    m_packed_page_area  = 0;
+
+    for (qsizetype group_index = 0; group_index < glyphs_per_group.size(); ++group_index)
+    {
+        QList<qsizetype>& glyphs_to_insert = glyphs_per_group[group_index];
+
+        if (glyphs_to_insert.isEmpty())
+        {
+            continue;
+        }
+
+        auto maybe_pages = pack_glyphs(glyphs, std::move(glyphs_to_insert), max_page_extent);
+
+        if (!maybe_pages.has_value())
+        {
+            return {};
+        }
+
+        if (group_index < page_groups.size())
+        {
+            PageGroup& group       = page_groups[group_index];
+            group.first_page_index = int(pages.size());
+            group.page_count       = int(maybe_pages->size());
+            used_page_groups.append(group);
+        }
+
+        pages.append(std::move(*maybe_pages));
+    }
+
+    end_stage();
+
+    page_groups = std::move(used_page_groups);
+
+    for (int p = 0; p < pages.size(); ++p)
+    {
+        const FontPage& page = pages[p];
+
+        for (const qsizetype glyph_index : page.glyph_indices)
+        {
+            Glyph& glyph     = glyphs[glyph_index];
+            glyph.page_index = p;
+        }
+    }
 
+#if !defined(NDEBUG) || defined(BMFGEN_VERIFY_ATLAS)
+    verify_pages(glyphs, pages);
+#endif
+
+    begin_stage(FontGenStage::Compositing, glyphs.size());
     MoveGlyphDataToTheirPages(glyphs, pages);
+    end_stage();
 
     return pages;
 }
@@ -305,6 +556,111 @@ static QBrush get_brush_for_fill(ImageCache&      image_cache,
     return {};
 }
 
+// Merges the fill and outline coverage of a glyph into a premultiplied ARGB32 image:
+// R = fill, G = outline, B = 0, A = fill over outline.
+// Since R and G never exceed A, the premultiplied values are the coverages themselves.
+static QImage merge_coverage_channels(const QImage& fill_coverage, const QImage& outline_coverage)
+{
+    QImage image{fill_coverage.size(), QImage::Format_ARGB32_Premultiplied};
+
+    for (int y = 0; y < image.height(); ++y)
+    {
+        const uchar* fill_row    = fill_coverage.constScanLine(y);
+        const uchar* outline_row = outline_coverage.constScanLine(y);
+        auto*        dst_row     = reinterpret_cast<QRgb*>(image.scanLine(y));
+
+        for (int x = 0; x < image.width(); ++x)
+        {
+            const int fill    = fill_row[x];
+            const int outline = outline_row[x];
+            const int alpha   = fill + (outline * (255 - fill) + 127) / 255;
+
+            dst_row[x] = qRgba(fill, outline, 0, alpha);
+        }
+    }
+
+    return image;
+}
+
+// Returns the pairs of glyphs of a variation whose spacing the font adjusts, in pixels.
+// QRawFont applies the kerning table of the font ('kern'), not the positioning of OpenType
+// layout tables (GPOS), which would require shaping every pair as a string.
+// Stops early (returning the pairs found so far) when canceled.
+static QList<KerningPair> compute_kerning_pairs(const QFont&             qfont,
+                                                const QList<Glyph>&      all_glyphs,
+                                                const QList<qsizetype>&  glyph_indices,
+                                                const std::atomic<bool>& is_canceled)
+{
+    const QRawFont raw_font = QRawFont::fromFont(qfont);
+
+    if (!raw_font.isValid())
+    {
+        return {};
+    }
+
+    const qsizetype count = glyph_indices.size();
+
+    QList<QChar>   characters(count);
+    QList<quint32> font_glyphs(count);
+    QList<QPointF> advances(count);
+
+    for (qsizetype i = 0; i < count; ++i)
+    {
+        int glyph_count = 1;
+        characters[i]   = all_glyphs[glyph_indices[i]].character;
+
+        if (!raw_font.glyphIndexesForChars(&characters[i], 1, &font_glyphs[i], &glyph_count))
+        {
+            font_glyphs[i] = 0;
+        }
+    }
+
+    raw_font.advancesForGlyphIndexes(
+        font_glyphs.constData(), advances.data(), int(count), QRawFont::SeparateAdvances);
+
+    // Each first glyph is followed by every second glyph in turn, so that a single call kerns it
+    // against all of them: the advance at 2 * j is that of the first glyph, kerned against j.
+    QList<quint32> sequence(count * 2);
+    QList<QPointF> kerned_advances(count * 2);
+
+    for (qsizetype j = 0; j < count; ++j)
+    {
+        sequence[j * 2 + 1] = font_glyphs[j];
+    }
+
+    QList<KerningPair> pairs;
+
+    for (qsizetype i = 0; i < count && !is_canceled; ++i)
+    {
+        // Glyph 0 is the font's placeholder for missing characters.
+        if (font_glyphs[i] == 0)
+        {
+            continue;
+        }
+
+        for (qsizetype j = 0; j < count; ++j)
+        {
+            sequence[j * 2] = font_glyphs[i];
+        }
+
+        raw_font.advancesForGlyphIndexes(sequence.constData(),
+                                         kerned_advances.data(),
+                                         int(sequence.size()),
+                                         QRawFont::KernedAdvances);
+
+        for (qsizetype j = 0; j < count; ++j)
+        {
+            const int amount = qRound(kerned_advances[j * 2].x() - advances[i].x());
+
+            if (font_glyphs[j] != 0 && amount != 0)
+            {
+                pairs.append(KerningPair{characters[i], characters[j], amount});
+            }
+        }
+    }
+
+    return pairs;
+}
 
 std::shared_ptr<GeneratedFont> FontGenContext::generate_bitmap_font(
     const FontModel& font, std::optional<QSet<QChar>> characters_override)
@@ -330,12 +686,17 @@ std::shared_ptr<GeneratedFont> FontGenContext::generate_bitmap_font(
 
     const int outline_width = is_outlined ? font.stroke_spread() : 0;
 
+    const QHash<QChar, int>& frequency_ranks = load_frequency_ranks(font);
+
     QList<GeneratedFont::Variation> variations;
     variations.reserve(font.variations().size());
 
     QList<Glyph> all_glyphs;
     all_glyphs.reserve(characters.size() * font.variations().size());
 
+    begin_stage(FontGenStage::Rasterizing, characters.size() * font.variations().size());
+    qsizetype rasterized_count = 0;
+
     for (const auto& variation : font.variations())
     {
         Q_ASSERT(variation >= 0.5);
@@ -367,6 +728,8 @@ std::shared_ptr<GeneratedFont> FontGenContext::generate_bitmap_font(
 
         for (const auto ch : characters)
         {
+            report_progress(++rasterized_count);
+
             if (!font_metrics.inFont(ch))
             {
                 continue;
@@ -386,20 +749,18 @@ std::shared_ptr<GeneratedFont> FontGenContext::generate_bitmap_font(
                 .character          = ch,
                 .rect               = QRect{0, 0, glyphSize.width(), glyphSize.height()},
                 .page_index         = 0,
+                .offset             = QPoint{-outline_width, -outline_width},
                 .horizontal_advance = font_metrics.horizontalAdvance(ch),
                 .left_bearing       = font_metrics.leftBearing(ch),
                 .right_bearing      = font_metrics.rightBearing(ch),
-                .image = QImage{glyphSize.width(), glyphSize.height(), QImage::Format_RGBA8888},
+                .frequency_rank     = frequency_ranks.value(ch, -1),
+                .image              = QImage{glyphSize.width(),
+                                             glyphSize.height(),
+                                             QImage::Format_ARGB32_Premultiplied},
             };
 
             glyph.image.fill(Qt::transparent);
 
-            QPainter painter{&glyph.image};
-            painter.setRenderHint(QPainter::TextAntialiasing, font.anti_aliasing());
-            painter.setRenderHint(QPainter::Antialiasing, font.anti_aliasing());
-            painter.setFont(qfont);
-            painter.setPen(Qt::white);
-
             // Draw
             const int text_pos_x = (extra_size.width()) / 2;
             const int text_pos_y = (extra_size.height() / 2) + font_metrics.ascent();
@@ -408,11 +769,9 @@ std::shared_ptr<GeneratedFont> FontGenContext::generate_bitmap_font(
             path.setFillRule(Qt::WindingFill);
             path.addText(text_pos_x, text_pos_y, qfont, chh_str);
 
-            if (is_outlined)
-            {
+            const auto make_outline_pen = [&](const QBrush& brush) {
                 QPen pen;
-                pen.setBrush(
-                    get_brush_for_fill(m_image_cache, font, font.stroke_fill(), glyphSize));
+                pen.setBrush(brush);
                 pen.setWidthF(outline_width);
                 pen.setStyle(font.stroke_style());
                 pen.setCapStyle(font.stroke_cap_style());
@@ -428,18 +787,64 @@ std::shared_ptr<GeneratedFont> FontGenContext::generate_bitmap_font(
                     pen.setDashOffset(font.stroke_dash_offset() * 0.05);
                 }
 
-                painter.strokePath(path, pen);
+                return pen;
+            };
+
+            if (font.coverage_channels())
+            {
+                // The colors are left to the renderer, which blends them by the coverages.
+                QImage fill_coverage{glyphSize, QImage::Format_Alpha8};
+                QImage outline_coverage{glyphSize, QImage::Format_Alpha8};
+                fill_coverage.fill(0);
+                outline_coverage.fill(0);
+
+                {
+                    QPainter painter{&fill_coverage};
+                    painter.setRenderHint(QPainter::Antialiasing, font.anti_aliasing());
+                    painter.fillPath(path, Qt::white);
+                }
+
+                if (is_outlined)
+                {
+                    QPainter painter{&outline_coverage};
+                    painter.setRenderHint(QPainter::Antialiasing, font.anti_aliasing());
+                    painter.strokePath(path, make_outline_pen(Qt::white));
+                }
+
+                glyph.image = merge_coverage_channels(fill_coverage, outline_coverage);
             }
+            else
+            {
+                QPainter painter{&glyph.image};
+                painter.setRenderHint(QPainter::TextAntialiasing, font.anti_aliasing());
+                painter.setRenderHint(QPainter::Antialiasing, font.anti_aliasing());
+                painter.setFont(qfont);
+                painter.setPen(Qt::white);
 
-            const QBrush fill_brush =
-                get_brush_for_fill(m_image_cache, font, font.base_fill(), glyphSize);
+                if (is_outlined)
+                {
+                    painter.strokePath(path,
+                                       make_outline_pen(get_brush_for_fill(
+                                           m_image_cache, font, font.stroke_fill(), glyphSize)));
+                }
 
-            painter.fillPath(path, fill_brush);
+                const QBrush fill_brush =
+                    get_brush_for_fill(m_image_cache, font, font.base_fill(), glyphSize);
+
+                painter.fillPath(path, fill_brush);
+            }
 
             glyph_indices.push_back(all_glyphs.size());
             all_glyphs.push_back(std::move(glyph));
         }
 
+        QList<KerningPair> kerning_pairs;
+
+        if (font.use_kerning())
+        {
+            kerning_pairs = compute_kerning_pairs(qfont, all_glyphs, glyph_indices, m_is_canceled);
+        }
+
         variations.push_back(GeneratedFont::Variation{
             .scale_factor       = variation,
             .line_height        = font_metrics.height(),
@@ -448,22 +853,107 @@ std::shared_ptr<GeneratedFont> FontGenContext::generate_bitmap_font(
             .line_gap           = font_metrics.lineSpacing(),
             .underline_position = font_metrics.underlinePos(),
             .glyph_indices      = std::move(glyph_indices),
+            .kerning_pairs      = std::move(kerning_pairs),
         });
     }
 
-    auto maybe_pages = create_font_pages(all_glyphs, font.max_page_extent());
+    end_stage();
+
+    QList<PageGroup> page_groups = build_page_groups(font);
+
+    auto maybe_pages =
+        create_font_pages(all_glyphs, font.max_page_extent(), font.page_grouping(), page_groups);
 
     if (!maybe_pages)
     {
+        // Packing gives up early when canceled.
+        if (m_is_canceled)
+        {
+            throw GenerationCanceledError();
+        }
+
         throw GlyphsDontFitError();
     }
 
+    for (FontPage& page : *maybe_pages)
+    {
+        page.has_coverage_channels = font.coverage_channels();
+    }
+
     return std::make_shared<GeneratedFont>(font.name(),
                                            font.qfont().pixelSize(),
+                                           font.anti_aliasing(),
+                                           outline_width,
                                            characters,
                                            std::move(all_glyphs),
                                            std::move(variations),
-                                           std::move(*maybe_pages));
+                                           std::move(*maybe_pages),
+                                           std::move(page_groups));
+}
+
+const QHash<QChar, int>& FontGenContext::load_frequency_ranks(const FontModel& font)
+{
+    if (font.frequency_corpus_filename().isEmpty())
+    {
+        m_corpus_filename.clear();
+        m_frequency_ranks.clear();
+        return m_frequency_ranks;
+    }
+
+    const QString   filename      = font.absolute_filename(font.frequency_corpus_filename());
+    const QDateTime last_modified = QFileInfo{filename}.lastModified();
+
+    if (filename == m_corpus_filename && last_modified == m_corpus_last_modified)
+    {
+        return m_frequency_ranks;
+    }
+
+    QFile file{filename};
+
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        throw InvalidFrequencyCorpusError();
+    }
+
+    // Count code points in chunks, so that large corpora don't have to be read at once.
+    std::vector<qsizetype> counts(std::numeric_limits<char16_t>::max() + 1);
+
+    QTextStream stream{&file};
+
+    while (!stream.atEnd())
+    {
+        for (const QChar ch : stream.read(64 * 1024))
+        {
+            ++counts[ch.unicode()];
+        }
+    }
+
+    QList<char16_t> code_points;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        if (counts[i] > 0)
+        {
+            code_points.push_back(char16_t(i));
+        }
+    }
+
+    std::ranges::stable_sort(code_points, [&counts](char16_t lhs, char16_t rhs) {
+        return counts[lhs] > counts[rhs];
+    });
+
+    m_frequency_ranks.clear();
+    m_frequency_ranks.reserve(code_points.size());
+
+    for (qsizetype rank = 0; rank < code_points.size(); ++rank)
+    {
+        m_frequency_ranks.insert(QChar(code_points[rank]), int(rank));
+    }
+
+    m_corpus_filename      = filename;
+    m_corpus_last_modified = last_modified;
+
+    return m_frequency_ranks;
 }
 
 FontGenContext::FontGenContext(QSet<QChar>* all_characters)
@@ -483,3 +973,63 @@ void FontGenContext::cancel()
 {
     m_is_canceled = true;
 }
+
+void FontGenContext::clear_cancellation()
+{
+    m_is_canceled = false;
+}
+
+static const char* font_gen_stage_name(FontGenStage stage)
+{
+    switch (stage)
+    {
+        case FontGenStage::Rasterizing: return "Rasterizing";
+        case FontGenStage::Packing: return "Packing";
+        case FontGenStage::Compositing: return "Compositing";
+    }
+
+    return "";
+}
+
+void FontGenContext::begin_stage(FontGenStage stage, qsizetype total)
+{
+    m_progress = FontGenProgress{
+        .stage = stage,
+        .total = total,
+    };
+
+    m_stage_timer.start();
+    m_last_report_ms = 0;
+
+    report_progress(0, true);
+}
+
+void FontGenContext::report_progress(qsizetype completed, bool force)
+{
+    // Reporting every glyph would flood receivers in other threads with queued signals.
+    constexpr qint64 report_interval_ms = 50;
+
+    m_progress.completed = completed;
+
+    const qint64 elapsed_ms = m_stage_timer.elapsed();
+
+    if (!force && elapsed_ms - m_last_report_ms < report_interval_ms)
+    {
+        return;
+    }
+
+    m_last_report_ms             = elapsed_ms;
+    m_progress.glyphs_per_second = elapsed_ms > 0 ? double(completed) * 1000.0 / elapsed_ms : 0.0;
+
+    emit progress_changed(m_progress);
+}
+
+void FontGenContext::end_stage()
+{
+    report_progress(m_progress.total, true);
+
+    qDebug("%s %lld glyphs took %lld ms",
+           font_gen_stage_name(m_progress.stage),
+           qlonglong(m_progress.total),
+           qlonglong(m_stage_timer.elapsed()));
+}
@@ -8,13 +8,34 @@
 #include "FontPage.hpp"
 #include "ImageCache.hpp"
 #include "MaxRectsBinPack.hpp"
+#include "PageGroup.hpp"
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QHash>
 #include <QObject>
+#include <atomic>
 #include <optional>
 
 class FontModel;
 class GeneratedFont;
 
+// The stages of a font generation, in the order in which they run.
+enum class FontGenStage
+{
+    Rasterizing, // Drawing the glyph images
+    Packing,     // Placing the glyphs on pages
+    Compositing, // Copying the glyph images to their pages
+};
+
+struct FontGenProgress
+{
+    FontGenStage stage{};
+    qsizetype    completed{};         // Glyphs that the stage has processed
+    qsizetype    total{};             // Glyphs that the stage processes
+    double       glyphs_per_second{}; // Since the stage began
+    float        occupancy{};         // Packing only: used area / area of the finished pages
+};
+
 class FontGenContext : public QObject
 {
     Q_OBJECT
@@ -25,15 +46,40 @@ class FontGenContext : public QObject
     std::shared_ptr<GeneratedFont> generate_font(const FontModel&                  model,
                                                  const std::optional<QSet<QChar>>& chars_override);
 
+    // Cancels the generation that is in progress, or the next one if none is, from any thread.
+    // Generations stay canceled until clear_cancellation() is called.
     void cancel();
 
+    // Called by whoever starts a generation or export, before it starts, so that a cancel that
+    // arrives in between isn't lost.
+    void clear_cancellation();
+
+  signals:
+    // Emitted from the generating thread when a stage begins and ends, and in between at most
+    // every 50 ms. Receivers in other threads get it queued; headless callers can connect
+    // directly.
+    void progress_changed(const FontGenProgress& progress);
+
   private:
+    void begin_stage(FontGenStage stage, qsizetype total);
+
+    void report_progress(qsizetype completed, bool force = false);
+
+    void end_stage();
+
     std::shared_ptr<GeneratedFont> generate_bitmap_font(const FontModel&           font,
                                                         std::optional<QSet<QChar>> chars_override);
 
-    std::optional<QList<FontPage>> pack_glyphs(QList<Glyph>& glyphs, int max_page_extent);
+    std::optional<QList<FontPage>> pack_glyphs(QList<Glyph>&    glyphs,
+                                               QList<qsizetype> glyphs_to_insert,
+                                               int              max_page_extent);
+
+    std::optional<QList<FontPage>> create_font_pages(QList<Glyph>&     glyphs,
+                                                     int               max_page_extent,
+                                                     PageGrouping      grouping,
+                                                     QList<PageGroup>& page_groups);
 
-    std::optional<QList<FontPage>> create_font_pages(QList<Glyph>& glyphs, int max_page_extent);
+    const QHash<QChar, int>& load_frequency_ranks(const FontModel& font);
 
     qsizetype insert_as_many_glyphs_as_possible(
         QList<Glyph>&                                        all_glyphs,
@@ -42,7 +88,15 @@ class FontGenContext : public QObject
         binpacking::MaxRectsBinPack::FreeRectChoiceHeuristic heuristic,
         QList<qsizetype>&                                    destination) const;
 
-    ImageCache   m_image_cache;
-    bool         m_is_canceled{};
-    QSet<QChar>* m_all_characters{};
+    ImageCache        m_image_cache;
+    std::atomic<bool> m_is_canceled{};
+    QSet<QChar>*      m_all_characters{};
+    QString           m_corpus_filename;
+    QDateTime         m_corpus_last_modified;
+    QHash<QChar, int> m_frequency_ranks;
+    FontGenProgress   m_progress;
+    QElapsedTimer     m_stage_timer;
+    qint64            m_last_report_ms{};
+    qint64            m_packed_glyph_area{};
+    qint64            m_packed_page_area{};
 };
@@ -199,6 +199,10 @@ std::optional<QString> FontModel::save_to_file(const QString& filename)
 
     root_obj.insert(QStringLiteral("max_page_extent"), m_max_page_extent);
     root_obj.insert("anti_aliasing", m_anti_aliasing);
+    root_obj.insert(QStringLiteral("page_grouping"), page_grouping_to_string(m_page_grouping));
+    root_obj.insert(QStringLiteral("page_groups"), m_page_groups);
+    root_obj.insert(QStringLiteral("frequency_corpus"), m_frequency_corpus_filename);
+    root_obj.insert(QStringLiteral("coverage_channels"), m_coverage_channels);
 
     root_obj.insert(QStringLiteral("desc_type"), [this] {
         switch (m_desc_type)
@@ -206,6 +210,11 @@ std::optional<QString> FontModel::save_to_file(const QString& filename)
             case FontDescriptionType::JSON: return QStringLiteral("json");
             case FontDescriptionType::XML: return QStringLiteral("xml");
             case FontDescriptionType::Text: return QStringLiteral("text");
+            case FontDescriptionType::Binary: return QStringLiteral("binary");
+            case FontDescriptionType::BMFontText: return QStringLiteral("bmfont_text");
+            case FontDescriptionType::BMFontBinary: return QStringLiteral("bmfont_binary");
+            case FontDescriptionType::Bundle: return QStringLiteral("bundle");
+            case FontDescriptionType::CppHeader: return QStringLiteral("cpp_header");
         }
         return QStringLiteral("binary");
     }());
@@ -213,6 +222,18 @@ std::optional<QString> FontModel::save_to_file(const QString& filename)
     root_obj.insert(QStringLiteral("image_type"), font_export_image_type_to_string(m_image_type));
     root_obj.insert(QStringLiteral("export_directory"), m_export_directory);
     root_obj.insert(QStringLiteral("flip_images_upside_down"), m_should_flip_images_upside_down);
+    root_obj.insert(QStringLiteral("premultiplied_alpha"),
+                    premultiplied_alpha_to_string(m_premultiplied_alpha));
+    root_obj.insert(QStringLiteral("png_compression_level"), m_png_compression_level);
+    root_obj.insert(QStringLiteral("png_palette"), m_use_png_palette);
+    root_obj.insert(QStringLiteral("compress_bundle_pages"), m_compress_bundle_pages);
+    root_obj.insert(QStringLiteral("compact_descriptors"), m_compact_descriptors);
+    root_obj.insert(QStringLiteral("header_pixel_format"),
+                    header_pixel_format_to_string(m_header_pixel_format));
+    root_obj.insert(QStringLiteral("pack_monochromatic_pages"), m_pack_monochromatic_pages);
+    root_obj.insert(QStringLiteral("bundle_gray_format"),
+                    bundle_gray_format_to_string(m_bundle_gray_format));
+    root_obj.insert(QStringLiteral("generate_mipmaps"), m_generate_mipmaps);
 
     root_obj.insert(QStringLiteral("preview_background_color"),
                     color_to_json(m_preview_background_color));
@@ -397,6 +418,16 @@ std::optional<QString> FontModel::load_from_file(const QString& filename)
 
     m_anti_aliasing = get_json_bool(obj, u"anti_aliasing").value_or(true);
 
+    m_page_grouping = page_grouping_from_string(
+        get_json_string(obj, QStringLiteral("page_grouping")).value_or(QString{}));
+
+    m_page_groups = get_json_string(obj, QStringLiteral("page_groups")).value_or(QString{});
+
+    m_frequency_corpus_filename =
+        get_json_string(obj, QStringLiteral("frequency_corpus")).value_or(QString{});
+
+    m_coverage_channels = get_json_bool(obj, QStringLiteral("coverage_channels")).value_or(false);
+
     const QString desc_str = get_json_string(obj, QStringLiteral("desc_type")).value_or(QString{});
     m_desc_type            = [desc_str] {
         if (desc_str == "json")
@@ -411,6 +442,26 @@ std::optional<QString> FontModel::load_from_file(const QString& filename)
         {
             return FontDescriptionType::Text;
         }
+        if (desc_str == "binary")
+        {
+            return FontDescriptionType::Binary;
+        }
+        if (desc_str == "bmfont_text")
+        {
+            return FontDescriptionType::BMFontText;
+        }
+        if (desc_str == "bmfont_binary")
+        {
+            return FontDescriptionType::BMFontBinary;
+        }
+        if (desc_str == "bundle")
+        {
+            return FontDescriptionType::Bundle;
+        }
+        if (desc_str == "cpp_header")
+        {
+            return FontDescriptionType::CppHeader;
+        }
 
         return static_cast<FontDescriptionType>(-1);
     }();
@@ -440,6 +491,31 @@ std::optional<QString> FontModel::load_from_file(const QString& filename)
     m_should_flip_images_upside_down =
         get_json_bool(obj, QStringLiteral("flip_images_upside_down")).value_or(false);
 
+    m_premultiplied_alpha = premultiplied_alpha_from_string(
+        get_json_string(obj, QStringLiteral("premultiplied_alpha")).value_or(QString{}));
+
+    m_png_compression_level =
+        std::clamp(get_json_int(obj, QStringLiteral("png_compression_level")).value_or(6), 0, 9);
+
+    m_use_png_palette = get_json_bool(obj, QStringLiteral("png_palette")).value_or(true);
+
+    m_compress_bundle_pages =
+        get_json_bool(obj, QStringLiteral("compress_bundle_pages")).value_or(false);
+
+    m_compact_descriptors =
+        get_json_bool(obj, QStringLiteral("compact_descriptors")).value_or(false);
+
+    m_header_pixel_format = header_pixel_format_from_string(
+        get_json_string(obj, QStringLiteral("header_pixel_format")).value_or(QString{}));
+
+    m_pack_monochromatic_pages =
+        get_json_bool(obj, QStringLiteral("pack_monochromatic_pages")).value_or(false);
+
+    m_bundle_gray_format = bundle_gray_format_from_string(
+        get_json_string(obj, QStringLiteral("bundle_gray_format")).value_or(QString{}));
+
+    m_generate_mipmaps = get_json_bool(obj, QStringLiteral("generate_mipmaps")).value_or(false);
+
     m_preview_background_color = get_json_color(obj, QStringLiteral("preview_background_color"))
                                      .value_or(QColor{54, 54, 54});
 
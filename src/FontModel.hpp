@@ -5,6 +5,7 @@
 #pragma once
 
 #include "GeneratedFont.hpp"
+#include "PageGroup.hpp"
 #include "QtDataModelUtil.hpp"
 #include <QFont>
 #include <QGradientStops>
@@ -22,6 +23,15 @@ class GlyphsDontFitError : public std::runtime_error
     }
 };
 
+class GenerationCanceledError : public std::runtime_error
+{
+  public:
+    explicit GenerationCanceledError()
+        : runtime_error("The font generation was canceled.")
+    {
+    }
+};
+
 class InvalidFontFaceError : public std::runtime_error
 {
   public:
@@ -40,6 +50,34 @@ class NoCharactersSelectedError : public std::runtime_error
     }
 };
 
+class InvalidPageGroupsError : public std::runtime_error
+{
+  public:
+    explicit InvalidPageGroupsError()
+        : runtime_error("The page groups are invalid. Expected a list such as "
+                        "'Latin: 0020-007F, 00A0-00FF; Cyrillic: 0400-04FF'.")
+    {
+    }
+};
+
+class InvalidFrequencyCorpusError : public std::runtime_error
+{
+  public:
+    explicit InvalidFrequencyCorpusError()
+        : runtime_error("Failed to read the frequency corpus file.")
+    {
+    }
+};
+
+class AtlasVerificationError : public std::runtime_error
+{
+  public:
+    explicit AtlasVerificationError()
+        : runtime_error("The packed glyphs overlap or exceed the bounds of their page.")
+    {
+    }
+};
+
 enum class FillType
 {
     None,
@@ -92,6 +130,14 @@ class FontModel : public QObject
 
     DEFINE_PROPERTY(bool, anti_aliasing, properties_changed);
 
+    DEFINE_PROPERTY(PageGrouping, page_grouping, properties_changed);
+
+    DEFINE_PROPERTY(QString, page_groups, properties_changed);
+
+    DEFINE_PROPERTY(QString, frequency_corpus_filename, properties_changed);
+
+    DEFINE_PROPERTY(bool, coverage_channels, properties_changed);
+
     DEFINE_PROPERTY(bool, use_kerning, properties_changed);
 
     DEFINE_PROPERTY(FontDescriptionType, desc_type, properties_only_relevant_for_save_changed);
@@ -104,8 +150,32 @@ class FontModel : public QObject
                     should_flip_images_upside_down,
                     properties_only_relevant_for_save_changed);
 
+    DEFINE_PROPERTY(PremultipliedAlpha,
+                    premultiplied_alpha,
+                    properties_only_relevant_for_save_changed);
+
     DEFINE_PROPERTY(bool, allow_monochromatic_images, properties_only_relevant_for_save_changed);
 
+    DEFINE_PROPERTY(int, png_compression_level, properties_only_relevant_for_save_changed);
+
+    DEFINE_PROPERTY(bool, use_png_palette, properties_only_relevant_for_save_changed);
+
+    DEFINE_PROPERTY(bool, compress_bundle_pages, properties_only_relevant_for_save_changed);
+
+    DEFINE_PROPERTY(bool, compact_descriptors, properties_only_relevant_for_save_changed);
+
+    DEFINE_PROPERTY(HeaderPixelFormat,
+                    header_pixel_format,
+                    properties_only_relevant_for_save_changed);
+
+    DEFINE_PROPERTY(bool, pack_monochromatic_pages, properties_only_relevant_for_save_changed);
+
+    DEFINE_PROPERTY(BundleGrayFormat,
+                    bundle_gray_format,
+                    properties_only_relevant_for_save_changed);
+
+    DEFINE_PROPERTY(bool, generate_mipmaps, properties_only_relevant_for_save_changed);
+
     DEFINE_PROPERTY(FontFill, base_fill, properties_changed);
 
     DEFINE_PROPERTY(FontFill, stroke_fill, properties_changed);
@@ -5,7 +5,12 @@
 #include "FontPage.hpp"
 
 FontPage::FontPage(QSize size)
-    : image(size, QImage::Format_RGBA8888)
+    : image(size, QImage::Format_ARGB32_Premultiplied)
 {
     image.fill(Qt::transparent);
 }
+
+FontPage::FontPage(QImage image)
+    : image(std::move(image))
+{
+}
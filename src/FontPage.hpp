@@ -13,6 +13,17 @@ class FontPage
   public:
     explicit FontPage(QSize size);
 
+    explicit FontPage(QImage image);
+
     QImage           image;
     QList<qsizetype> glyph_indices;
+    bool             is_monochromatic{}; // Determined once the page is complete
+
+    // Whether the page holds the fill and outline coverage of its glyphs instead of their colors:
+    // R = fill, G = outline, A = fill over outline (see FontModel::coverage_channels).
+    bool has_coverage_channels{};
+
+    // The number of monochromatic pages whose coverage is packed into the channels of this
+    // page's (straight RGBA8888) image, or 0 if this is a regular page.
+    int packed_page_count{};
 };
@@ -4,30 +4,61 @@
 
 #include "GeneratedFont.hpp"
 
+#include "BinaryFontFormat.hpp"
+#include "BufferedWriter.hpp"
+#include "ExportManifest.hpp"
+#include "JsonStreamWriter.hpp"
+#include "MipmapGenerator.hpp"
+#include "QoiEncoder.hpp"
 #include "QtImageUtil.hpp"
+#include "TextureContainer.hpp"
+#include <QBuffer>
+#include <QCryptographicHash>
 #include <QFileDialog>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QStringList>
 #include <QXmlStreamWriter>
+#include <QtConcurrentMap>
+#include <QtEndian>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <numeric>
 #include <ostream>
+#include <span>
+#include <sstream>
 #include <stdexcept>
 
 FontExportImageType font_export_image_type_from_string(const QString& value)
 {
-    if (value == "png")
+    if (value.compare("png", Qt::CaseInsensitive) == 0)
     {
         return FontExportImageType::Png;
     }
 
-    if (value == "bmp")
+    if (value.compare("bmp", Qt::CaseInsensitive) == 0)
     {
         return FontExportImageType::Bmp;
     }
 
+    if (value.compare("dds", Qt::CaseInsensitive) == 0)
+    {
+        return FontExportImageType::Dds;
+    }
+
+    if (value.compare("ktx2", Qt::CaseInsensitive) == 0)
+    {
+        return FontExportImageType::Ktx2;
+    }
+
+    if (value.compare("qoi", Qt::CaseInsensitive) == 0)
+    {
+        return FontExportImageType::Qoi;
+    }
+
     return FontExportImageType::Png;
 }
 
@@ -37,29 +68,155 @@ QString font_export_image_type_to_string(FontExportImageType type)
     {
         case FontExportImageType::Png: return QStringLiteral("PNG");
         case FontExportImageType::Bmp: return QStringLiteral("BMP");
+        case FontExportImageType::Dds: return QStringLiteral("DDS");
+        case FontExportImageType::Ktx2: return QStringLiteral("KTX2");
+        case FontExportImageType::Qoi: return QStringLiteral("QOI");
     }
 
     return QStringLiteral("PNG");
 }
 
+PremultipliedAlpha premultiplied_alpha_from_string(const QString& value)
+{
+    if (value == "srgb")
+    {
+        return PremultipliedAlpha::Srgb;
+    }
+
+    if (value == "linear")
+    {
+        return PremultipliedAlpha::Linear;
+    }
+
+    return PremultipliedAlpha::None;
+}
+
+QString premultiplied_alpha_to_string(PremultipliedAlpha value)
+{
+    switch (value)
+    {
+        case PremultipliedAlpha::None: return QStringLiteral("none");
+        case PremultipliedAlpha::Srgb: return QStringLiteral("srgb");
+        case PremultipliedAlpha::Linear: return QStringLiteral("linear");
+    }
+
+    return QStringLiteral("none");
+}
+
+HeaderPixelFormat header_pixel_format_from_string(const QString& value)
+{
+    if (value == "gray8")
+    {
+        return HeaderPixelFormat::Gray8;
+    }
+
+    if (value == "gray4")
+    {
+        return HeaderPixelFormat::Gray4;
+    }
+
+    if (value == "gray1")
+    {
+        return HeaderPixelFormat::Gray1;
+    }
+
+    return HeaderPixelFormat::Rgba8;
+}
+
+QString header_pixel_format_to_string(HeaderPixelFormat value)
+{
+    switch (value)
+    {
+        case HeaderPixelFormat::Rgba8: return QStringLiteral("rgba8");
+        case HeaderPixelFormat::Gray8: return QStringLiteral("gray8");
+        case HeaderPixelFormat::Gray4: return QStringLiteral("gray4");
+        case HeaderPixelFormat::Gray1: return QStringLiteral("gray1");
+    }
+
+    return QStringLiteral("rgba8");
+}
+
+BundleGrayFormat bundle_gray_format_from_string(const QString& value)
+{
+    if (value == "gray4")
+    {
+        return BundleGrayFormat::Gray4;
+    }
+
+    if (value == "gray1")
+    {
+        return BundleGrayFormat::Gray1;
+    }
+
+    return BundleGrayFormat::Gray8;
+}
+
+QString bundle_gray_format_to_string(BundleGrayFormat value)
+{
+    switch (value)
+    {
+        case BundleGrayFormat::Gray8: return QStringLiteral("gray8");
+        case BundleGrayFormat::Gray4: return QStringLiteral("gray4");
+        case BundleGrayFormat::Gray1: return QStringLiteral("gray1");
+    }
+
+    return QStringLiteral("gray8");
+}
+
+static int bits_per_pixel(HeaderPixelFormat format)
+{
+    switch (format)
+    {
+        case HeaderPixelFormat::Rgba8: return 32;
+        case HeaderPixelFormat::Gray8: return 8;
+        case HeaderPixelFormat::Gray4: return 4;
+        case HeaderPixelFormat::Gray1: return 1;
+    }
+
+    return 32;
+}
+
+static int bits_per_pixel(BundleGrayFormat format)
+{
+    switch (format)
+    {
+        case BundleGrayFormat::Gray8: return 8;
+        case BundleGrayFormat::Gray4: return 4;
+        case BundleGrayFormat::Gray1: return 1;
+    }
+
+    return 8;
+}
 
 GeneratedFont::GeneratedFont(QString          name,
                              int              base_size,
+                             bool             is_anti_aliased,
+                             int              outline_thickness,
                              QSet<QChar>      characters,
                              QList<Glyph>     all_glyphs,
                              QList<Variation> variations,
-                             QList<FontPage>  pages)
+                             QList<FontPage>  pages,
+                             QList<PageGroup> page_groups)
     : m_name(std::move(name))
     , m_base_size(base_size)
+    , m_is_anti_aliased(is_anti_aliased)
+    , m_outline_thickness(outline_thickness)
     , m_chars(std::move(characters))
     , m_all_glyphs(std::move(all_glyphs))
     , m_variations(std::move(variations))
     , m_pages(std::move(pages))
+    , m_page_groups(std::move(page_groups))
 {
     for (Variation& var : m_variations)
     {
         var.parent_font = this;
     }
+
+    // Size estimates and exports both depend on this, so it's only determined once.
+    QtConcurrent::blockingMap(m_pages, [](FontPage& page) {
+        page.is_monochromatic =
+            page.packed_page_count == 0 && QtImageUtil::is_monochromatic(page.image);
+    });
 }
 
 bool GeneratedFont::has_char(QChar character) const
@@ -72,6 +229,16 @@ int GeneratedFont::base_size() const
     return m_base_size;
 }
 
+bool GeneratedFont::is_anti_aliased() const
+{
+    return m_is_anti_aliased;
+}
+
+int GeneratedFont::outline_thickness() const
+{
+    return m_outline_thickness;
+}
+
 const QList<Glyph>& GeneratedFont::all_glyphs() const
 {
     return m_all_glyphs;
@@ -108,11 +275,35 @@ const FontPage& GeneratedFont::page_at(int index) const
     return m_pages[index];
 }
 
-void GeneratedFont::export_to_disk(const QString&      directory,
-                                   FontDescriptionType font_description_type,
-                                   FontExportImageType image_type,
-                                   bool                flip_images_upside_down,
-                                   bool                allow_monochromatic_images) const
+const QList<PageGroup>& GeneratedFont::page_groups() const
+{
+    return m_page_groups;
+}
+
+void FontExportProgress::report(FontExportStage stage, int completed, int total) const
+{
+    if (on_progress)
+    {
+        on_progress(stage, completed, total);
+    }
+}
+
+bool FontExportProgress::is_canceled() const
+{
+    return cancel_requested && cancel_requested();
+}
+
+void FontExportProgress::throw_if_canceled() const
+{
+    if (is_canceled())
+    {
+        throw ExportCanceledError();
+    }
+}
+
+void GeneratedFont::export_to_disk(const QString&            directory,
+                                   const FontExportOptions&  options,
+                                   const FontExportProgress& progress) const
 {
     qDebug("Exporting font to disk: %s", qPrintable(directory));
 
@@ -122,41 +313,291 @@ void GeneratedFont::export_to_disk(const QString&      directory,
             QStringLiteral("Failed to create directory '%1'").arg(directory).toStdString()};
     }
 
-    std::optional<QStringList> images_filenames =
-        export_images(directory, image_type, flip_images_upside_down, allow_monochromatic_images);
+    // C++ headers are never channel-packed, since they choose their pixel format explicitly.
+    if (options.pack_monochromatic_pages &&
+        options.description_type != FontDescriptionType::CppHeader)
+    {
+        FontExportOptions packed_options        = options;
+        packed_options.pack_monochromatic_pages = false;
+
+        with_channel_packed_pages()->export_to_disk(directory, packed_options, progress);
+        return;
+    }
+
+    // Only files that changed since the last export are written, so that their modification
+    // times stay untouched.
+    ExportManifest manifest{
+        QDir::cleanPath(directory + QDir::separator() + m_name + ".manifest.json")};
+
+    manifest.set_cache_key(build_cache_key());
 
-    if (!images_filenames.has_value())
+    if (options.description_type == FontDescriptionType::Bundle)
     {
-        throw std::runtime_error{"Failed to export the font images."};
+        // Bundles contain the pages themselves.
+        export_as_bundle(directory, options, manifest, progress);
+        manifest.save();
+        progress.report(FontExportStage::Description, 1, 1);
+        return;
     }
 
+    if (options.description_type == FontDescriptionType::CppHeader)
+    {
+        // Headers contain the pages themselves.
+        export_as_cpp_header(directory, options, manifest, progress);
+        manifest.save();
+        progress.report(FontExportStage::Description, 1, 1);
+        return;
+    }
+
+    // BMFont's binary format requires all page filenames to be of equal length.
+    const bool pad_page_numbers = options.description_type == FontDescriptionType::BMFontText ||
+                                  options.description_type == FontDescriptionType::BMFontBinary;
+
     const ExportArgs args{
         .directory        = directory,
-        .images_filenames = *images_filenames,
+        .images_filenames =
+            export_images(directory, options, pad_page_numbers, manifest, progress),
+        .manifest       = &manifest,
+        .compact_schema = options.compact_descriptors,
     };
 
-    switch (font_description_type)
+    progress.throw_if_canceled();
+    progress.report(FontExportStage::Description, 0, 1);
+
+    switch (options.description_type)
     {
         case FontDescriptionType::JSON: export_as_json(args); break;
-        case FontDescriptionType::XML: export_as_xml(args); break;
+        case FontDescriptionType::XML:
+            if (args.compact_schema)
+            {
+                export_as_compact_xml(args);
+            }
+            else
+            {
+                export_as_xml(args);
+            }
+            break;
         case FontDescriptionType::Text: export_as_text(args); break;
+        case FontDescriptionType::Binary: export_as_binary(args); break;
+        case FontDescriptionType::BMFontText: export_as_bmfont_text(args); break;
+        case FontDescriptionType::BMFontBinary: export_as_bmfont_binary(args); break;
+        case FontDescriptionType::Bundle:
+        case FontDescriptionType::CppHeader: break;
+    }
+
+    manifest.save();
+
+    progress.report(FontExportStage::Description, 1, 1);
+}
+
+QList<qsizetype> GeneratedFont::channel_packing_runs() const
+{
+    // Pages of different groups must stay apart, so that groups can still be loaded on their own.
+    QList<int> group_of_page(m_pages.size(), -1);
+
+    for (qsizetype i = 0; i < m_page_groups.size(); ++i)
+    {
+        const PageGroup& group = m_page_groups[i];
+
+        for (int p = group.first_page_index; p < group.first_page_index + group.page_count; ++p)
+        {
+            group_of_page[p] = int(i);
+        }
+    }
+
+    QList<qsizetype> runs;
+    qsizetype        first = 0;
+
+    while (first < m_pages.size())
+    {
+        qsizetype count = 1;
+
+        if (m_pages[first].is_monochromatic)
+        {
+            while (count < 4 && first + count < m_pages.size() &&
+                   m_pages[first + count].is_monochromatic &&
+                   group_of_page[first + count] == group_of_page[first])
+            {
+                ++count;
+            }
+        }
+
+        runs.append(count);
+        first += count;
+    }
+
+    return runs;
+}
+
+std::shared_ptr<GeneratedFont> GeneratedFont::with_channel_packed_pages() const
+{
+    QList<FontPage> pages;
+    QList<int>      new_page_index(m_pages.size());
+    QList<int>      channel_of_page(m_pages.size(), -1);
+
+    qsizetype first = 0;
+
+    for (const qsizetype count : channel_packing_runs())
+    {
+        if (count == 1)
+        {
+            new_page_index[first] = int(pages.size());
+            pages.append(m_pages[first]);
+            ++first;
+            continue;
+        }
+
+        QSize size{};
+
+        for (qsizetype i = 0; i < count; ++i)
+        {
+            size = size.expandedTo(m_pages[first + i].image.size());
+        }
+
+        FontPage packed{QImage{size, QImage::Format_RGBA8888}};
+        packed.image.fill(0);
+        packed.packed_page_count = int(count);
+
+        for (qsizetype i = 0; i < count; ++i)
+        {
+            const FontPage& page = m_pages[first + i];
+            const QImage    src  = page.image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+            for (int y = 0; y < src.height(); ++y)
+            {
+                const auto* src_row = reinterpret_cast<const QRgb*>(src.constScanLine(y));
+                uchar*      dst_row = packed.image.scanLine(y) + i;
+
+                for (int x = 0; x < src.width(); ++x)
+                {
+                    dst_row[x * 4] = uchar(qAlpha(src_row[x]));
+                }
+            }
+
+            packed.glyph_indices.append(page.glyph_indices);
+            new_page_index[first + i]  = int(pages.size());
+            channel_of_page[first + i] = int(i);
+        }
+
+        pages.append(std::move(packed));
+        first += count;
+    }
+
+    QList<Glyph> glyphs = m_all_glyphs;
+
+    for (Glyph& glyph : glyphs)
+    {
+        if (glyph.page_index >= 0 && glyph.page_index < m_pages.size())
+        {
+            glyph.channel    = channel_of_page[glyph.page_index];
+            glyph.page_index = new_page_index[glyph.page_index];
+        }
+    }
+
+    QList<PageGroup> page_groups = m_page_groups;
+
+    for (PageGroup& group : page_groups)
+    {
+        if (group.page_count > 0)
+        {
+            const int last_page_index = group.first_page_index + group.page_count - 1;
+
+            group.first_page_index = new_page_index[group.first_page_index];
+            group.page_count       = new_page_index[last_page_index] - group.first_page_index + 1;
+        }
+    }
+
+    // The font is copied instead of constructed, so that the pages that are kept as they are
+    // aren't scanned for monochromaticity again. Packed pages are never monochromatic.
+    auto packed_font = std::make_shared<GeneratedFont>(*this);
+
+    packed_font->m_all_glyphs  = std::move(glyphs);
+    packed_font->m_pages       = std::move(pages);
+    packed_font->m_page_groups = std::move(page_groups);
+
+    for (Variation& var : packed_font->m_variations)
+    {
+        var.parent_font = packed_font.get();
     }
+
+    return packed_font;
 }
 
-qsizetype GeneratedFont::size_in_bytes(bool allow_monochromatic_images) const
+qsizetype GeneratedFont::size_in_bytes(const FontExportOptions& options) const
 {
+    const auto levels_size_in_bytes = [&](const QSize& size, int bits) {
+        const int level_count =
+            options.generate_mipmaps && options.description_type != FontDescriptionType::CppHeader
+                ? MipmapGenerator::level_count(size.width(), size.height())
+                : 1;
+
+        qsizetype sum = 0;
+
+        for (int level = 0; level < level_count; ++level)
+        {
+            const int width  = std::max(size.width() >> level, 1);
+            const int height = std::max(size.height() >> level, 1);
+
+            sum += QtImageUtil::packed_row_pitch(width, bits) * height;
+        }
+
+        return sum;
+    };
+
+    const auto page_size_in_bytes = [&](const FontPage& page) {
+        int bits = 32; // RGBA
+
+        if (options.description_type == FontDescriptionType::CppHeader)
+        {
+            bits = bits_per_pixel(options.header_pixel_format);
+        }
+        else if (is_exported_as_gray(page, options))
+        {
+            // Grayscale images, or coverage in bundles.
+            bits = options.description_type == FontDescriptionType::Bundle
+                       ? bits_per_pixel(options.bundle_gray_format)
+                       : 8;
+        }
+
+        return levels_size_in_bytes(page.image.size(), bits);
+    };
+
     qsizetype sum = 0;
 
-    for (const auto& page : m_pages)
+    // Mirrors export_to_disk(), which exports with_channel_packed_pages() instead, without
+    // packing any pixels: each run of packed pages becomes a single RGBA page.
+    if (options.pack_monochromatic_pages &&
+        options.description_type != FontDescriptionType::CppHeader)
     {
-        int byte_stride = 4; // 32-bit RGBA
+        qsizetype first = 0;
 
-        if (allow_monochromatic_images && QtImageUtil::is_monochromatic(page.image))
+        for (const qsizetype count : channel_packing_runs())
         {
-            byte_stride = 1;
+            if (count == 1)
+            {
+                sum += page_size_in_bytes(m_pages[first]);
+            }
+            else
+            {
+                QSize size{};
+
+                for (qsizetype i = 0; i < count; ++i)
+                {
+                    size = size.expandedTo(m_pages[first + i].image.size());
+                }
+
+                sum += levels_size_in_bytes(size, 32);
+            }
+
+            first += count;
         }
 
-        sum += page.image.width() * page.image.height() * byte_stride;
+        return sum;
+    }
+
+    for (const auto& page : m_pages)
+    {
+        sum += page_size_in_bytes(page);
     }
 
     return sum;
@@ -203,21 +644,48 @@ const GeneratedFont::Variation& GeneratedFont::variation_by_scale(double scale)
     return m_variations.first();
 }
 
+// The binary writers below always emit little-endian values, regardless of the host.
+
+static inline void write(std::ostream& ofs, uint8_t value)
+{
+    ofs.put(static_cast<char>(value));
+}
+
+static inline void write(std::ostream& ofs, int16_t value)
+{
+    value = qToLittleEndian(value);
+    ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static inline void write(std::ostream& ofs, uint16_t value)
+{
+    value = qToLittleEndian(value);
+    ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
 static inline void write(std::ostream& ofs, int32_t value)
 {
+    value = qToLittleEndian(value);
     ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
 }
 
 static inline void write(std::ostream& ofs, uint32_t value)
 {
+    value = qToLittleEndian(value);
     ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
 }
 
 static inline void write(std::ostream& ofs, uint64_t value)
 {
+    value = qToLittleEndian(value);
     ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
 }
 
+static inline void write(std::ostream& ofs, float value)
+{
+    write(ofs, std::bit_cast<uint32_t>(value));
+}
+
 static inline void write(std::ostream& ofs, const QString& value_)
 {
     const std::string value = value_.toStdString();
@@ -225,179 +693,672 @@ static inline void write(std::ostream& ofs, const QString& value_)
     ofs.write(value.c_str(), value.length());
 }
 
-std::optional<QStringList> GeneratedFont::export_images(const QString&      directory,
-                                                        FontExportImageType type,
-                                                        bool                flip_upside_down,
-                                                        bool allow_monochromatic) const
+static inline uint32_t stream_position(std::ostream& ofs)
 {
-    QStringList filenames;
+    return static_cast<uint32_t>(ofs.tellp());
+}
 
-    int index{};
+static inline void pad_to_alignment(std::ostream& ofs, uint32_t alignment)
+{
+    while (static_cast<uint64_t>(ofs.tellp()) % alignment != 0)
+    {
+        ofs.put('\0');
+    }
+}
 
-    for (const auto& page : m_pages)
+// Writes a descriptor file, unless its contents are unchanged since the last export.
+static void write_file_if_changed(ExportManifest&   manifest,
+                                  const QString&    filename,
+                                  const QByteArray& contents)
+{
+    if (!manifest.update(filename, ExportManifest::hash(contents)))
     {
-        const char* extension = [type]() {
-            switch (type)
-            {
-                case FontExportImageType::Png: return ".png";
-                case FontExportImageType::Bmp: return ".bmp";
-            }
+        qDebug("Skipping unchanged file '%s'", qPrintable(filename));
+        return;
+    }
 
-            return "";
-        }();
+    QFile file{filename};
 
-        const QString filename =
-            QDir::cleanPath(directory + QDir::separator() +
-                            QStringLiteral("%1_%2%3").arg(m_name).arg(index).arg(extension));
+    if (!file.open(QFile::WriteOnly))
+    {
+        throw std::runtime_error(
+            QStringLiteral("Failed to open file '%1' for writing.").arg(filename).toStdString());
+    }
 
-        QImage image = flip_upside_down ? page.image.mirrored(false, true) : page.image;
+    if (file.write(contents) != contents.size())
+    {
+        throw std::runtime_error(
+            QStringLiteral("Failed to write file '%1'.").arg(filename).toStdString());
+    }
+}
 
-        if (image.isNull())
+// Returns a key of everything that an exported page is generated from: its pixels, the export
+// settings that affect it and, for mipmaps, the rectangles of its glyphs.
+static QByteArray page_export_key(const FontPage&          page,
+                                  const QList<Glyph>&      glyphs,
+                                  const FontExportOptions& options)
+{
+    const QImage& image = page.image;
+
+    const QByteArray settings = QStringLiteral("%1;%2;%3;%4;%5;%6;%7;%8;%9;%10")
+                                    .arg(image.width())
+                                    .arg(image.height())
+                                    .arg(int(image.format()))
+                                    .arg(int(options.image_type))
+                                    .arg(int(options.flip_images_upside_down))
+                                    .arg(int(options.allow_monochromatic_images))
+                                    .arg(options.png.compression_level)
+                                    .arg(int(options.png.allow_palette))
+                                    .arg(int(options.premultiplied_alpha))
+                                    .arg(int(options.generate_mipmaps))
+                                    .toLatin1();
+
+    QCryptographicHash hash{QCryptographicHash::Md5};
+    hash.addData(settings);
+    hash.addData(QByteArrayView{image.constBits(), image.sizeInBytes()});
+
+    // Smaller mip levels are downsampled per glyph rectangle.
+    if (options.generate_mipmaps)
+    {
+        for (const qsizetype glyph_index : page.glyph_indices)
         {
-            qCritical("Failed to save image to: %s", qPrintable(filename));
-            return std::nullopt;
-        }
+            const QRect& rect = glyphs[glyph_index].rect;
 
-        if (allow_monochromatic && QtImageUtil::is_monochromatic(image))
-        {
-            image.convertTo(QImage::Format_Grayscale8);
+            const std::array<int, 4> coords{rect.x(), rect.y(), rect.width(), rect.height()};
+            hash.addData(QByteArrayView{reinterpret_cast<const char*>(coords.data()),
+                                        qsizetype(sizeof(coords))});
         }
+    }
 
-        if (!image.save(filename))
-        {
-            return std::nullopt;
-        }
+    return hash.result().toHex();
+}
 
-        filenames.append(filename);
+// The layout in which RGBA pages are written to disk.
+static PixelLayout rgba_export_layout(const FontPage& page, const FontExportOptions& options)
+{
+    // Channel-packed pages hold four independent coverages, which are neither colors nor
+    // premultiplied by each other. They are written as they are.
+    if (page.packed_page_count > 0)
+    {
+        return PixelLayout::Rgba8888;
+    }
 
-        ++index;
+    // Coverage channels must not be divided by the combined coverage.
+    if (page.has_coverage_channels)
+    {
+        return PixelLayout::Rgba8888Premultiplied;
     }
 
-    return filenames;
+    switch (options.premultiplied_alpha)
+    {
+        case PremultipliedAlpha::None: return PixelLayout::Rgba8888;
+        case PremultipliedAlpha::Srgb: return PixelLayout::Rgba8888Premultiplied;
+        case PremultipliedAlpha::Linear: return PixelLayout::Rgba8888LinearPremultiplied;
+    }
+
+    return PixelLayout::Rgba8888;
 }
 
-void GeneratedFont::export_as_json(const ExportArgs& args) const
+// Returns whether a page is written as a gray image (or gray coverage, in bundles) instead of
+// RGBA.
+static bool is_exported_as_gray(const FontPage& page, const FontExportOptions& options)
 {
-    QJsonObject root_obj;
+    return options.allow_monochromatic_images && page.is_monochromatic &&
+           !page.has_coverage_channels && page.packed_page_count == 0;
+}
 
-    root_obj.insert("name", m_name);
-    root_obj.insert("baseSize", m_base_size);
+// Converts a page to the image that is written to disk: Grayscale8 for monochromatic pages
+// (if allowed), RGBA8888 in the layout of rgba_export_layout() otherwise.
+// Premultiplied pages are returned as QImage::Format_RGBA8888 as well, so that encoders store
+// their bytes as they are.
+// Flipping is folded into the conversion, which creates the exported image anyway, so that
+// only channel-packed pages (which need no conversion) are copied just to be flipped.
+static QImage prepare_image_for_export(const QImage&           page_image,
+                                       const FontPage&          page,
+                                       const FontExportOptions& options)
+{
+    const bool flip = options.flip_images_upside_down;
 
-    // Pages
+    if (page_image.isNull() || page.packed_page_count > 0)
     {
-        root_obj.insert("pageCount", m_pages.size());
+        // Channel-packed pages already are straight RGBA8888.
+        return flip ? page_image.mirrored(false, true) : page_image;
+    }
 
-        QJsonArray pages_array;
-        qsizetype  index = 0;
+    // Pages are rasterized in premultiplied ARGB32, which is QPainter's fastest format.
+    // Only now are they converted to the layout that is written to disk.
+    if (is_exported_as_gray(page, options))
+    {
+        QImage image = page_image.convertToFormat(QImage::Format_Grayscale8);
+
+        // The converted image isn't shared, so the rvalue overload flips it in place.
+        return flip ? std::move(image).mirrored(false, true) : image;
+    }
+
+    QImage image = QtImageUtil::convert(page_image, rgba_export_layout(page, options), flip);
+    image.reinterpretAsFormat(QImage::Format_RGBA8888);
+
+    return image;
+}
+
+// Returns the mip levels of a page (only the page itself if mipmaps are disabled), as they
+// are rasterized: neither flipped nor converted. Levels are filtered with premultiplied alpha
+// and never across glyph boundaries.
+static QList<QImage> generate_page_levels(const FontPage&          page,
+                                          const QList<Glyph>&      glyphs,
+                                          const FontExportOptions& options)
+{
+    if (!options.generate_mipmaps || page.image.isNull())
+    {
+        return {page.image};
+    }
+
+    QList<QRect> glyph_rects;
+    QList<int>   glyph_channels;
+    glyph_rects.reserve(page.glyph_indices.size());
+
+    for (const qsizetype glyph_index : page.glyph_indices)
+    {
+        glyph_rects.append(glyphs[glyph_index].rect);
+    }
+
+    // Glyphs of channel-packed pages overlap across channels, so each channel is filtered
+    // with the glyphs of its own source page only.
+    if (page.packed_page_count > 0)
+    {
+        for (const qsizetype glyph_index : page.glyph_indices)
+        {
+            glyph_channels.append(glyphs[glyph_index].channel);
+        }
+    }
+
+    return MipmapGenerator::generate(page.image, glyph_rects, glyph_channels);
+}
+
+// Returns the mip levels of a page, each prepared for export.
+static QList<QImage> prepare_page_levels_for_export(const FontPage&          page,
+                                                    const QList<Glyph>&      glyphs,
+                                                    const FontExportOptions& options)
+{
+    QList<QImage> levels = generate_page_levels(page, glyphs, options);
+
+    for (QImage& level : levels)
+    {
+        level = prepare_image_for_export(level, page, options);
+    }
+
+    return levels;
+}
+
+// Writes a page and its mip levels as a GPU-ready texture: BC4 for grayscale pages,
+// BC7 otherwise.
+static bool save_block_compressed(const QList<QImage>& levels,
+                                  const QString&       filename,
+                                  FontExportImageType  type,
+                                  PixelLayout          rgba_layout)
+{
+    const QImage& image   = levels.first();
+    const bool    is_gray = image.format() == QImage::Format_Grayscale8;
+
+    const TextureAlphaMode alpha_mode = [&] {
+        switch (rgba_layout)
+        {
+            case PixelLayout::Rgba8888:
+            case PixelLayout::Bgra8888: return TextureAlphaMode::Straight;
+            case PixelLayout::Rgba8888Premultiplied: return TextureAlphaMode::Premultiplied;
+            case PixelLayout::Rgba8888LinearPremultiplied:
+                return TextureAlphaMode::LinearPremultiplied;
+        }
+
+        return TextureAlphaMode::Straight;
+    }();
+
+    CompressedTexture texture{
+        .format     = is_gray ? BlockFormat::Bc4 : BlockFormat::Bc7,
+        .alpha_mode = alpha_mode,
+        .width      = image.width(),
+        .height     = image.height(),
+    };
+
+    for (const QImage& level : levels)
+    {
+        texture.levels.append(is_gray ? BlockCompressor::compress_bc4(level)
+                                      : BlockCompressor::compress_bc7(level));
+    }
+
+    const QByteArray data = type == FontExportImageType::Dds
+                                ? TextureContainer::encode_dds(texture)
+                                : TextureContainer::encode_ktx2(texture);
+
+    QFile file{filename};
+
+    if (!file.open(QFile::WriteOnly))
+    {
+        return false;
+    }
+
+    return file.write(data) == data.size();
+}
+
+// BMFont assumes that all pages have the same size; report the largest one.
+static QSize bmfont_page_size(const QList<FontPage>& pages)
+{
+    QSize size{};
+
+    for (const auto& page : pages)
+    {
+        size = size.expandedTo(page.image.size());
+    }
+
+    return size;
+}
+
+static bool has_channel_packed_pages(const QList<FontPage>& pages)
+{
+    return std::any_of(pages.cbegin(), pages.cend(), [](const FontPage& page) {
+        return page.packed_page_count > 0;
+    });
+}
+
+static bool has_coverage_channels(const QList<FontPage>& pages)
+{
+    return std::any_of(pages.cbegin(), pages.cend(), [](const FontPage& page) {
+        return page.has_coverage_channels;
+    });
+}
+
+// The contents of the alpha, red, green and blue channels in BMFont's terms:
+// 0 = glyph, 1 = outline, 2 = glyph and outline, 3 = zero.
+static std::array<uint8_t, 4> bmfont_channel_contents(const QList<FontPage>& pages)
+{
+    if (has_coverage_channels(pages))
+    {
+        return {2, 0, 1, 3};
+    }
+
+    return {0, 0, 0, 0};
+}
+
+// BMFont's chnl bits: 1 = blue, 2 = green, 4 = red, 8 = alpha, 15 = all channels.
+static uint8_t bmfont_channel(const Glyph& glyph)
+{
+    switch (glyph.channel)
+    {
+        case 0: return 4;
+        case 1: return 2;
+        case 2: return 1;
+        case 3: return 8;
+        default: return 15;
+    }
+}
+
+QStringList GeneratedFont::export_images(const QString&            directory,
+                                         const FontExportOptions&  options,
+                                         bool                      pad_page_numbers,
+                                         ExportManifest&           manifest,
+                                         const FontExportProgress& progress) const
+{
+    const char* extension = [type = options.image_type]() {
+        switch (type)
+        {
+            case FontExportImageType::Png: return ".png";
+            case FontExportImageType::Bmp: return ".bmp";
+            case FontExportImageType::Dds: return ".dds";
+            case FontExportImageType::Ktx2: return ".ktx2";
+            case FontExportImageType::Qoi: return ".qoi";
+        }
+
+        return "";
+    }();
+
+    const int page_number_width =
+        pad_page_numbers ? int(QString::number(std::max(m_pages.size() - 1, qsizetype(0))).size())
+                         : 0;
+
+    // Filenames are determined up-front, so that the result doesn't depend on the order in
+    // which the pages finish encoding.
+    QStringList filenames;
+    filenames.reserve(m_pages.size());
+
+    for (qsizetype index = 0; index < m_pages.size(); ++index)
+    {
+        filenames.append(QDir::cleanPath(directory + QDir::separator() +
+                                         QStringLiteral("%1_%2%3")
+                                             .arg(m_name)
+                                             .arg(index, page_number_width, 10, QChar('0'))
+                                             .arg(extension)));
+    }
+
+    QList<qsizetype> page_indices(m_pages.size());
+    std::iota(page_indices.begin(), page_indices.end(), qsizetype(0));
+
+    // Block-compressed textures contain their mip levels, other formats store each level in a
+    // file of its own: <name>_<page>_mip<level>.<extension>.
+    const bool is_block_compressed = options.image_type == FontExportImageType::Dds ||
+                                     options.image_type == FontExportImageType::Ktx2;
+
+    const auto level_filename = [&](const QString& filename, int level) {
+        if (level == 0)
+        {
+            return filename;
+        }
+
+        return QStringLiteral("%1_mip%2%3")
+            .arg(filename.chopped(qsizetype(std::strlen(extension))))
+            .arg(level)
+            .arg(extension);
+    };
+
+    // Encoding (especially PNG) dominates the export time, and pages are independent of each
+    // other, so each page is converted and encoded on its own worker.
+    // Returns an error message, or an empty string on success.
+    const auto export_page = [&](qsizetype index) -> QString {
+        const FontPage&  page     = m_pages[index];
+        const QString&   filename = filenames[index];
+        const QByteArray key      = page_export_key(page, m_all_glyphs, options);
+
+        const int file_count =
+            options.generate_mipmaps && !is_block_compressed
+                ? MipmapGenerator::level_count(page.image.width(), page.image.height())
+                : 1;
+
+        // Every file is recorded in the manifest, even if another one of the page changed.
+        bool is_changed = false;
+
+        for (int level = 0; level < file_count; ++level)
+        {
+            if (manifest.update(level_filename(filename, level), key))
+            {
+                is_changed = true;
+            }
+        }
+
+        if (!is_changed)
+        {
+            qDebug("Skipping unchanged page %d", int(index));
+            return QString{};
+        }
+
+        const QList<QImage> levels = prepare_page_levels_for_export(page, m_all_glyphs, options);
+
+        if (levels.first().isNull())
+        {
+            return QStringLiteral("Failed to prepare page %1 for export.").arg(index);
+        }
+
+        bool saved = true;
+
+        if (is_block_compressed)
+        {
+            saved = save_block_compressed(
+                levels, filename, options.image_type, rgba_export_layout(page, options));
+        }
+
+        for (int level = 0; level < file_count && saved; ++level)
+        {
+            const QImage& image          = levels[level];
+            const QString image_filename = level_filename(filename, level);
+
+            switch (options.image_type)
+            {
+                case FontExportImageType::Png:
+                    saved = PngEncoder::save(image, image_filename, options.png);
+                    break;
+                case FontExportImageType::Bmp: saved = image.save(image_filename); break;
+                case FontExportImageType::Dds:
+                case FontExportImageType::Ktx2: break;
+                case FontExportImageType::Qoi:
+                    saved = QoiEncoder::save(image, image_filename);
+                    break;
+            }
+        }
+
+        if (!saved)
+        {
+            return QStringLiteral("Failed to save page %1 to '%2'.").arg(index).arg(filename);
+        }
+
+        return QString{};
+    };
+
+    const int        page_count = int(m_pages.size());
+    std::atomic<int> completed_page_count{0};
+
+    progress.report(FontExportStage::Pages, 0, page_count);
+
+    // Pages that haven't started when the export is canceled are skipped.
+    const auto export_page_and_report = [&](qsizetype index) -> QString {
+        if (progress.is_canceled())
+        {
+            return QString{};
+        }
+
+        const QString error = export_page(index);
+        progress.report(FontExportStage::Pages, ++completed_page_count, page_count);
+
+        return error;
+    };
+
+    const QStringList results =
+        QtConcurrent::blockingMapped<QStringList>(page_indices, export_page_and_report);
+
+    progress.throw_if_canceled();
+
+    QStringList errors;
+
+    for (const QString& error : results)
+    {
+        if (!error.isEmpty())
+        {
+            qCritical("%s", qPrintable(error));
+            errors.append(error);
+        }
+    }
+
+    if (!errors.isEmpty())
+    {
+        throw std::runtime_error{errors.join('\n').toStdString()};
+    }
+
+    return filenames;
+}
+
+void GeneratedFont::export_as_json(const ExportArgs& args) const
+{
+    // The JSON is streamed instead of building a QJsonObject tree first, which would hold
+    // one object per glyph in memory.
+    QByteArray contents;
+    QBuffer    buffer{&contents};
+    buffer.open(QIODevice::WriteOnly);
+
+    JsonStreamWriter json{&buffer};
+
+    json.begin_object();
+    json.write("name", m_name);
+    json.write("baseSize", m_base_size);
+
+    // Pages
+    {
+        json.write("pageCount", m_pages.size());
+        json.begin_array("pages");
+
+        qsizetype index = 0;
 
         for (const auto& page : m_pages)
         {
-            QJsonObject page_obj;
-            page_obj.insert("index", index);
-            page_obj.insert("filename", QFileInfo{args.images_filenames.at(index)}.fileName());
-            page_obj.insert("width", page.image.width());
-            page_obj.insert("height", page.image.height());
+            json.begin_object();
+
+            // Compact descriptors list entries in index order, so indices are implicit.
+            if (!args.compact_schema)
+            {
+                json.write("index", index);
+            }
 
-            pages_array.push_back(page_obj);
+            json.write("filename", QFileInfo{args.images_filenames.at(index)}.fileName());
+            json.write("width", page.image.width());
+            json.write("height", page.image.height());
+            json.end_object();
 
             ++index;
         }
 
-        root_obj.insert("pages", pages_array);
+        json.end_array();
+    }
+
+    // Page groups
+    {
+        json.write("pageGroupCount", m_page_groups.size());
+        json.begin_array("pageGroups");
+
+        for (const auto& group : m_page_groups)
+        {
+            json.begin_object();
+            json.write("name", group.name);
+            json.write("firstPageIndex", group.first_page_index);
+            json.write("pageCount", group.page_count);
+
+            json.begin_array("ranges");
+
+            for (const auto& range : group.ranges)
+            {
+                json.begin_object();
+                json.write("first", range.first);
+                json.write("last", range.last);
+                json.end_object();
+            }
+
+            json.end_array();
+
+            json.end_object();
+        }
+
+        json.end_array();
     }
 
     // Glyphs
+    if (args.compact_schema)
+    {
+        // One array per field instead of one object per glyph.
+        json.write("glyphCount", m_all_glyphs.size());
+        json.begin_object("glyphs");
+
+        const auto write_column = [&](std::string_view key, const auto& field) {
+            json.begin_inline_array(key);
+
+            for (const auto& glyph : m_all_glyphs)
+            {
+                json.write_element(field(glyph));
+            }
+
+            json.end_array();
+        };
+
+        write_column("codePoint", [](const Glyph& g) { return int(g.character.unicode()); });
+        write_column("x", [](const Glyph& g) { return g.rect.x(); });
+        write_column("y", [](const Glyph& g) { return g.rect.y(); });
+        write_column("width", [](const Glyph& g) { return g.rect.width(); });
+        write_column("height", [](const Glyph& g) { return g.rect.height(); });
+        write_column("pageIndex", [](const Glyph& g) { return g.page_index; });
+        write_column("horizontalAdvance", [](const Glyph& g) { return g.horizontal_advance; });
+        write_column("leftBearing", [](const Glyph& g) { return g.left_bearing; });
+        write_column("rightBearing", [](const Glyph& g) { return g.right_bearing; });
+        write_column("frequencyRank", [](const Glyph& g) { return g.frequency_rank; });
+        write_column("channel", [](const Glyph& g) { return g.channel; });
+
+        json.end_object();
+    }
+    else
     {
-        root_obj.insert("glyphCount", m_all_glyphs.size());
+        json.write("glyphCount", m_all_glyphs.size());
+        json.begin_array("glyphs");
 
-        QJsonArray glyphs_arr;
-        qsizetype  index = 0;
+        qsizetype index = 0;
 
         for (const auto& glyph : m_all_glyphs)
         {
-            QJsonObject glyphObj;
-            glyphObj.insert("index", index);
-            glyphObj.insert("character", QJsonValue::fromVariant(glyph.character));
-            glyphObj.insert("x", glyph.rect.x());
-            glyphObj.insert("y", glyph.rect.y());
-            glyphObj.insert("width", glyph.rect.width());
-            glyphObj.insert("height", glyph.rect.height());
-            glyphObj.insert("pageIndex", glyph.page_index);
-            glyphObj.insert("horizontalAdvance", glyph.horizontal_advance);
-            glyphObj.insert("leftBearing", glyph.left_bearing);
-            glyphObj.insert("rightBearing", glyph.right_bearing);
-
-            glyphs_arr.push_back(glyphObj);
+            json.begin_object();
+            json.write("index", index);
+            json.write("character", QStringView{&glyph.character, 1});
+            json.write("x", glyph.rect.x());
+            json.write("y", glyph.rect.y());
+            json.write("width", glyph.rect.width());
+            json.write("height", glyph.rect.height());
+            json.write("pageIndex", glyph.page_index);
+            json.write("horizontalAdvance", glyph.horizontal_advance);
+            json.write("leftBearing", glyph.left_bearing);
+            json.write("rightBearing", glyph.right_bearing);
+            json.write("frequencyRank", glyph.frequency_rank);
+            json.write("channel", glyph.channel);
+            json.end_object();
 
             ++index;
         }
 
-        root_obj.insert("glyphs", glyphs_arr);
+        json.end_array();
     }
 
     // Variations
     {
-        root_obj.insert("variationCount", m_variations.size());
-
-        QJsonArray variations_json_arr;
+        json.write("variationCount", m_variations.size());
+        json.begin_array("variations");
 
         qsizetype index = 0;
 
         for (const auto& variation : m_variations)
         {
-            QJsonObject obj;
-            obj.insert("index", index);
-            obj.insert("scaleFactor", variation.scale_factor);
-            obj.insert("pixelSize", variation.pixel_size());
-            obj.insert("lineHeight", variation.line_height);
-            obj.insert("ascent", variation.ascent);
-            obj.insert("descent", variation.descent);
-            obj.insert("lineGap", variation.line_gap);
-            obj.insert("underlinePosition", variation.underline_position);
+            json.begin_object();
+
+            if (!args.compact_schema)
+            {
+                json.write("index", index);
+            }
 
-            QJsonArray glyph_indices_arr;
+            json.write("scaleFactor", variation.scale_factor);
+            json.write("pixelSize", variation.pixel_size());
+            json.write("lineHeight", variation.line_height);
+            json.write("ascent", variation.ascent);
+            json.write("descent", variation.descent);
+            json.write("lineGap", variation.line_gap);
+            json.write("underlinePosition", variation.underline_position);
+
+            if (args.compact_schema)
+            {
+                json.begin_inline_array("glyphIndices");
+            }
+            else
+            {
+                json.begin_array("glyphIndices");
+            }
 
             for (const auto glyph_index : variation.glyph_indices)
             {
-                glyph_indices_arr.append(QJsonValue::fromVariant(int(glyph_index)));
+                json.write_element(glyph_index);
             }
 
-            obj.insert("glyphIndices", glyph_indices_arr);
+            json.end_array();
 
-            variations_json_arr.append(obj);
+            json.end_object();
 
             ++index;
         }
 
-        root_obj.insert("variations", variations_json_arr);
+        json.end_array();
     }
 
-    const QString filename = QDir::cleanPath(args.directory + QDir::separator() + m_name + ".json");
-
-    QFile file{filename};
+    json.end_object();
+    json.flush();
 
-    if (!file.open(QFile::WriteOnly))
-    {
-        throw std::runtime_error(
-            QStringLiteral("Failed to open file '%1' for writing.").arg(filename).toStdString());
-    }
+    const QString filename = QDir::cleanPath(args.directory + QDir::separator() + m_name + ".json");
 
-    file.write(QJsonDocument{root_obj}.toJson());
+    write_file_if_changed(*args.manifest, filename, contents);
 }
 
 void GeneratedFont::export_as_xml(const ExportArgs& args) const
 {
     const QString filename = QDir::cleanPath(args.directory + QDir::separator() + m_name + ".xml");
 
-    QFile file{filename};
-
-    if (!file.open(QFile::WriteOnly))
-    {
-        throw std::runtime_error(
-            QStringLiteral("Failed to open file '%1' for writing.").arg(filename).toStdString());
-    }
-
-    QXmlStreamWriter stream{&file};
+    QByteArray       contents;
+    QXmlStreamWriter stream{&contents};
     stream.setAutoFormatting(true);
     stream.writeStartDocument();
 
@@ -427,6 +1388,35 @@ void GeneratedFont::export_as_xml(const ExportArgs& args) const
         stream.writeEndElement(); // pages
     }
 
+    // Page groups
+    {
+        stream.writeTextElement("pageGroupCount", QString::number(m_page_groups.size()));
+
+        stream.writeStartElement("pageGroups");
+
+        for (const auto& group : m_page_groups)
+        {
+            stream.writeStartElement("pageGroup");
+            stream.writeTextElement("name", group.name);
+            stream.writeTextElement("firstPageIndex", QString::number(group.first_page_index));
+            stream.writeTextElement("pageCount", QString::number(group.page_count));
+
+            stream.writeStartElement("ranges");
+            for (const auto& range : group.ranges)
+            {
+                stream.writeStartElement("range");
+                stream.writeAttribute("first", QString::number(range.first));
+                stream.writeAttribute("last", QString::number(range.last));
+                stream.writeEndElement();
+            }
+            stream.writeEndElement(); // ranges
+
+            stream.writeEndElement(); // pageGroup
+        }
+
+        stream.writeEndElement(); // pageGroups
+    }
+
     // Glyphs
     {
         stream.writeTextElement("glyphCount", QString::number(m_all_glyphs.size()));
@@ -448,6 +1438,8 @@ void GeneratedFont::export_as_xml(const ExportArgs& args) const
             stream.writeTextElement("horizontalAdvance", QString::number(glyph.horizontal_advance));
             stream.writeTextElement("leftBearing", QString::number(glyph.left_bearing));
             stream.writeTextElement("rightBearing", QString::number(glyph.right_bearing));
+            stream.writeTextElement("frequencyRank", QString::number(glyph.frequency_rank));
+            stream.writeTextElement("channel", QString::number(glyph.channel));
 
             stream.writeEndElement(); // glyph
 
@@ -497,68 +1489,218 @@ void GeneratedFont::export_as_xml(const ExportArgs& args) const
     stream.writeEndElement(); // font
 
     stream.writeEndDocument();
+
+    write_file_if_changed(*args.manifest, filename, contents);
 }
 
-void GeneratedFont::export_as_text(const ExportArgs& args) const
+void GeneratedFont::export_as_compact_xml(const ExportArgs& args) const
 {
-    const QString filename = QDir::cleanPath(args.directory + QDir::separator() + m_name + ".txt");
-
-    QFile file{filename};
-
-    if (!file.open(QFile::WriteOnly))
-    {
-        throw std::runtime_error(
-            QStringLiteral("Failed to open file '%1' for writing.").arg(filename).toStdString());
-    }
-
-    constexpr char nl = '\n';
+    const QString filename = QDir::cleanPath(args.directory + QDir::separator() + m_name + ".xml");
 
-    QTextStream w{&file};
+    QByteArray       contents;
+    QXmlStreamWriter stream{&contents};
+    stream.setAutoFormatting(true);
+    stream.writeStartDocument();
 
-    w << "name " << m_name << nl;
-    w << "baseSize " << m_base_size << nl;
+    // Each entry is a single element whose fields are attributes. Elements appear in index
+    // order, so indices are implicit.
+    stream.writeStartElement("font");
+    stream.writeAttribute("name", m_name);
+    stream.writeAttribute("baseSize", QString::number(m_base_size));
 
     // Pages
     {
-        w << "pageCount " << m_pages.size() << nl;
-        w << "pages" << nl;
+        stream.writeStartElement("pages");
+        stream.writeAttribute("count", QString::number(m_pages.size()));
 
         qsizetype index = 0;
         for (const auto& page : m_pages)
         {
-            w << "page" << nl;
-            w << "index " << index << nl;
-            w << "filename " << QFileInfo{args.images_filenames.at(index)}.fileName() << nl;
-            w << "width " << page.image.width() << nl;
-            w << "height " << page.image.height() << nl;
-            w << "end" << nl;
+            stream.writeEmptyElement("page");
+            stream.writeAttribute("filename",
+                                  QFileInfo{args.images_filenames.at(index)}.fileName());
+            stream.writeAttribute("width", QString::number(page.image.width()));
+            stream.writeAttribute("height", QString::number(page.image.height()));
             ++index;
         }
 
-        w << "end" << nl;
+        stream.writeEndElement(); // pages
     }
 
-    // Glyphs
+    // Page groups
     {
-        w << "glyphCount " << m_all_glyphs.size() << nl;
-        w << "glyphs" << nl;
+        stream.writeStartElement("pageGroups");
+        stream.writeAttribute("count", QString::number(m_page_groups.size()));
 
-        qsizetype index = 0;
-
-        for (const auto& glyph : m_all_glyphs)
+        for (const auto& group : m_page_groups)
         {
-            w << "glyph" << nl;
+            QStringList ranges;
+            ranges.reserve(group.ranges.size());
 
-            w << "index " << index << nl;
-            w << "character " << glyph.character << nl;
-            w << "x " << glyph.rect.x() << nl;
-            w << "y " << glyph.rect.y() << nl;
+            for (const auto& range : group.ranges)
+            {
+                ranges.append(QStringLiteral("%1-%2").arg(range.first).arg(range.last));
+            }
+
+            stream.writeEmptyElement("pageGroup");
+            stream.writeAttribute("name", group.name);
+            stream.writeAttribute("firstPageIndex", QString::number(group.first_page_index));
+            stream.writeAttribute("pageCount", QString::number(group.page_count));
+            stream.writeAttribute("ranges", ranges.join(' '));
+        }
+
+        stream.writeEndElement(); // pageGroups
+    }
+
+    // Glyphs
+    {
+        stream.writeStartElement("glyphs");
+        stream.writeAttribute("count", QString::number(m_all_glyphs.size()));
+
+        for (const auto& glyph : m_all_glyphs)
+        {
+            stream.writeEmptyElement("glyph");
+            stream.writeAttribute("codePoint", QString::number(int(glyph.character.unicode())));
+            stream.writeAttribute("x", QString::number(glyph.rect.x()));
+            stream.writeAttribute("y", QString::number(glyph.rect.y()));
+            stream.writeAttribute("width", QString::number(glyph.rect.width()));
+            stream.writeAttribute("height", QString::number(glyph.rect.height()));
+            stream.writeAttribute("pageIndex", QString::number(glyph.page_index));
+            stream.writeAttribute("horizontalAdvance", QString::number(glyph.horizontal_advance));
+            stream.writeAttribute("leftBearing", QString::number(glyph.left_bearing));
+            stream.writeAttribute("rightBearing", QString::number(glyph.right_bearing));
+            stream.writeAttribute("frequencyRank", QString::number(glyph.frequency_rank));
+            stream.writeAttribute("channel", QString::number(glyph.channel));
+        }
+
+        stream.writeEndElement(); // glyphs
+    }
+
+    // Variations
+    {
+        stream.writeStartElement("variations");
+        stream.writeAttribute("count", QString::number(m_variations.size()));
+
+        for (const auto& variation : m_variations)
+        {
+            QString glyph_indices;
+            glyph_indices.reserve(variation.glyph_indices.size() * 5);
+
+            for (const auto glyph_index : variation.glyph_indices)
+            {
+                if (!glyph_indices.isEmpty())
+                {
+                    glyph_indices += ' ';
+                }
+
+                glyph_indices += QString::number(glyph_index);
+            }
+
+            stream.writeEmptyElement("variation");
+            stream.writeAttribute("scaleFactor", QString::number(variation.scale_factor));
+            stream.writeAttribute("pixelSize", QString::number(variation.pixel_size()));
+            stream.writeAttribute("lineHeight", QString::number(variation.line_height));
+            stream.writeAttribute("ascent", QString::number(variation.ascent));
+            stream.writeAttribute("descent", QString::number(variation.descent));
+            stream.writeAttribute("lineGap", QString::number(variation.line_gap));
+            stream.writeAttribute("underlinePosition",
+                                  QString::number(variation.underline_position));
+            stream.writeAttribute("glyphIndices", glyph_indices);
+        }
+
+        stream.writeEndElement(); // variations
+    }
+
+    stream.writeEndElement(); // font
+
+    stream.writeEndDocument();
+
+    write_file_if_changed(*args.manifest, filename, contents);
+}
+
+void GeneratedFont::export_as_text(const ExportArgs& args) const
+{
+    const QString filename = QDir::cleanPath(args.directory + QDir::separator() + m_name + ".txt");
+
+    constexpr char nl = '\n';
+
+    QByteArray contents;
+    QBuffer    buffer{&contents};
+    buffer.open(QIODevice::WriteOnly);
+
+    BufferedWriter w{&buffer};
+
+    w << "name " << m_name << nl;
+    w << "baseSize " << m_base_size << nl;
+
+    // Pages
+    {
+        w << "pageCount " << m_pages.size() << nl;
+        w << "pages" << nl;
+
+        qsizetype index = 0;
+        for (const auto& page : m_pages)
+        {
+            w << "page" << nl;
+            w << "index " << index << nl;
+            w << "filename " << QFileInfo{args.images_filenames.at(index)}.fileName() << nl;
+            w << "width " << page.image.width() << nl;
+            w << "height " << page.image.height() << nl;
+            w << "end" << nl;
+            ++index;
+        }
+
+        w << "end" << nl;
+    }
+
+    // Page groups
+    {
+        w << "pageGroupCount " << m_page_groups.size() << nl;
+        w << "pageGroups" << nl;
+
+        for (const auto& group : m_page_groups)
+        {
+            w << "pageGroup" << nl;
+            w << "name " << group.name << nl;
+            w << "firstPageIndex " << group.first_page_index << nl;
+            w << "pageCount " << group.page_count << nl;
+
+            w << "ranges";
+            for (const auto& range : group.ranges)
+            {
+                w << " " << range.first << "-" << range.last;
+            }
+            w << nl;
+
+            w << "end" << nl;
+        }
+
+        w << "end" << nl;
+    }
+
+    // Glyphs
+    {
+        w << "glyphCount " << m_all_glyphs.size() << nl;
+        w << "glyphs" << nl;
+
+        qsizetype index = 0;
+
+        for (const auto& glyph : m_all_glyphs)
+        {
+            w << "glyph" << nl;
+
+            w << "index " << index << nl;
+            w << "character " << glyph.character << nl;
+            w << "x " << glyph.rect.x() << nl;
+            w << "y " << glyph.rect.y() << nl;
             w << "width " << glyph.rect.width() << nl;
             w << "height " << glyph.rect.height() << nl;
             w << "pageIndex " << glyph.page_index << nl;
             w << "horizontalAdvance " << glyph.horizontal_advance << nl;
             w << "leftBearing " << glyph.left_bearing << nl;
             w << "rightBearing " << glyph.right_bearing << nl;
+            w << "frequencyRank " << glyph.frequency_rank << nl;
+            w << "channel " << glyph.channel << nl;
 
             w << "end" << nl;
 
@@ -602,6 +1744,1156 @@ void GeneratedFont::export_as_text(const ExportArgs& args) const
     }
 
     w << nl;
+    w.flush();
+
+    write_file_if_changed(*args.manifest, filename, contents);
+}
+
+void GeneratedFont::export_as_binary(const ExportArgs& args) const
+{
+    const QString filename = QDir::cleanPath(args.directory + QDir::separator() + m_name + ".bin");
+
+    QStringList page_names;
+    page_names.reserve(args.images_filenames.size());
+
+    for (const auto& image_filename : args.images_filenames)
+    {
+        page_names.append(QFileInfo{image_filename}.fileName());
+    }
+
+    std::ostringstream ofs;
+    write_binary_descriptor(ofs, page_names);
+
+    write_file_if_changed(*args.manifest, filename, QByteArray::fromStdString(ofs.str()));
+}
+
+void GeneratedFont::write_binary_descriptor(std::ostream& ofs, const QStringList& page_names) const
+{
+    namespace bf = bmfgen::binary_format;
+
+    const auto align = [&ofs] { pad_to_alignment(ofs, bf::section_alignment); };
+
+    // The header is written last, once all offsets are known.
+    {
+        const std::array<char, sizeof(bf::FileHeader)> placeholder{};
+        ofs.write(placeholder.data(), placeholder.size());
+    }
+
+    // Strings
+    const auto write_string = [&ofs](const QString& str) {
+        const uint32_t   offset = stream_position(ofs);
+        const QByteArray utf8   = str.toUtf8();
+        ofs.write(utf8.constData(), utf8.size());
+        ofs.put('\0');
+        return offset;
+    };
+
+    const uint32_t name_offset = write_string(m_name);
+
+    QList<uint32_t> page_filename_offsets;
+    page_filename_offsets.reserve(m_pages.size());
+
+    for (const auto& page_name : page_names)
+    {
+        page_filename_offsets.append(write_string(page_name));
+    }
+
+    QList<uint32_t> page_group_name_offsets;
+    page_group_name_offsets.reserve(m_page_groups.size());
+
+    for (const auto& group : m_page_groups)
+    {
+        page_group_name_offsets.append(write_string(group.name));
+    }
+
+    // Pages
+    align();
+    const uint32_t page_table_offset = stream_position(ofs);
+
+    for (qsizetype i = 0; i < m_pages.size(); ++i)
+    {
+        write(ofs, page_filename_offsets.at(i));
+        write(ofs, uint32_t(m_pages[i].image.width()));
+        write(ofs, uint32_t(m_pages[i].image.height()));
+        write(ofs, uint32_t(0));
+    }
+
+    // Page groups
+    align();
+    QList<uint32_t> page_group_ranges_offsets;
+    page_group_ranges_offsets.reserve(m_page_groups.size());
+
+    for (const auto& group : m_page_groups)
+    {
+        page_group_ranges_offsets.append(stream_position(ofs));
+
+        for (const auto& range : group.ranges)
+        {
+            write(ofs, range.first);
+            write(ofs, range.last);
+        }
+    }
+
+    align();
+    const uint32_t page_group_table_offset = stream_position(ofs);
+
+    for (qsizetype i = 0; i < m_page_groups.size(); ++i)
+    {
+        const PageGroup& group = m_page_groups[i];
+
+        write(ofs, page_group_name_offsets.at(i));
+        write(ofs, uint32_t(group.first_page_index));
+        write(ofs, uint32_t(group.page_count));
+        write(ofs, uint32_t(group.ranges.size()));
+        write(ofs, page_group_ranges_offsets.at(i));
+        write(ofs, uint32_t(0));
+        write(ofs, uint32_t(0));
+        write(ofs, uint32_t(0));
+    }
+
+    // Glyphs, stored as one array per attribute.
+    const auto write_glyph_array = [&](const auto& get_value) {
+        align();
+        const uint32_t offset = stream_position(ofs);
+
+        for (const auto& glyph : m_all_glyphs)
+        {
+            write(ofs, get_value(glyph));
+        }
+
+        return offset;
+    };
+
+    // Braced initialization guarantees left-to-right evaluation, i.e. file order.
+    const std::array<uint32_t, 11> glyph_array_offsets{
+        write_glyph_array([](const Glyph& g) { return uint32_t(g.character.unicode()); }),
+        write_glyph_array([](const Glyph& g) { return uint16_t(g.rect.x()); }),
+        write_glyph_array([](const Glyph& g) { return uint16_t(g.rect.y()); }),
+        write_glyph_array([](const Glyph& g) { return uint16_t(g.rect.width()); }),
+        write_glyph_array([](const Glyph& g) { return uint16_t(g.rect.height()); }),
+        write_glyph_array([](const Glyph& g) { return uint16_t(g.page_index); }),
+        write_glyph_array([](const Glyph& g) { return int16_t(g.horizontal_advance); }),
+        write_glyph_array([](const Glyph& g) { return int16_t(g.left_bearing); }),
+        write_glyph_array([](const Glyph& g) { return int16_t(g.right_bearing); }),
+        write_glyph_array([](const Glyph& g) { return int32_t(g.frequency_rank); }),
+        write_glyph_array([](const Glyph& g) { return uint8_t(int8_t(g.channel)); }),
+    };
+
+    align();
+    const uint32_t glyph_table_offset = stream_position(ofs);
+
+    for (const uint32_t offset : glyph_array_offsets)
+    {
+        write(ofs, offset);
+    }
+
+    write(ofs, uint32_t(0));
+
+    // Variations, each with its glyph indices and code point index.
+    struct VariationOffsets
+    {
+        uint32_t glyph_indices_offset{};
+        uint32_t index_offset{};
+        uint32_t index_block_count{};
+    };
+
+    QList<VariationOffsets> variation_offsets;
+    variation_offsets.reserve(m_variations.size());
+
+    for (const auto& variation : m_variations)
+    {
+        VariationOffsets offsets;
+
+        align();
+        offsets.glyph_indices_offset = stream_position(ofs);
+
+        for (const auto glyph_index : variation.glyph_indices)
+        {
+            write(ofs, uint32_t(glyph_index));
+        }
+
+        std::array<uint16_t, 256>        level1{};
+        QList<std::array<uint32_t, 256>> blocks;
+
+        level1.fill(bf::no_index_block);
+
+        for (const auto glyph_index : variation.glyph_indices)
+        {
+            const char16_t code_point = m_all_glyphs[glyph_index].character.unicode();
+            uint16_t&      block      = level1[code_point >> 8];
+
+            if (block == bf::no_index_block)
+            {
+                block = uint16_t(blocks.size());
+                blocks.emplace_back().fill(bf::no_glyph);
+            }
+
+            blocks[block][code_point & 0xFF] = uint32_t(glyph_index);
+        }
+
+        align();
+        offsets.index_offset      = stream_position(ofs);
+        offsets.index_block_count = uint32_t(blocks.size());
+
+        for (const uint16_t block : level1)
+        {
+            write(ofs, block);
+        }
+
+        for (const auto& block : blocks)
+        {
+            for (const uint32_t glyph_index : block)
+            {
+                write(ofs, glyph_index);
+            }
+        }
+
+        variation_offsets.append(offsets);
+    }
+
+    align();
+    const uint32_t variation_table_offset = stream_position(ofs);
+
+    for (qsizetype i = 0; i < m_variations.size(); ++i)
+    {
+        const Variation&        variation = m_variations[i];
+        const VariationOffsets& offsets   = variation_offsets[i];
+
+        write(ofs, float(variation.scale_factor));
+        write(ofs, int32_t(variation.pixel_size()));
+        write(ofs, int32_t(variation.line_height));
+        write(ofs, int32_t(variation.ascent));
+        write(ofs, int32_t(variation.descent));
+        write(ofs, int32_t(variation.line_gap));
+        write(ofs, int32_t(variation.underline_position));
+        write(ofs, uint32_t(variation.glyph_indices.size()));
+        write(ofs, offsets.glyph_indices_offset);
+        write(ofs, offsets.index_offset);
+        write(ofs, offsets.index_block_count);
+        write(ofs, uint32_t(0));
+    }
+
+    const uint32_t file_size = stream_position(ofs);
+
+    // Header
+    ofs.seekp(0);
+    ofs.write(bf::magic.data(), bf::magic.size());
+    write(ofs, bf::version);
+    write(ofs, file_size);
+    write(ofs, int32_t(m_base_size));
+    write(ofs, name_offset);
+    write(ofs, uint32_t(m_pages.size()));
+    write(ofs, page_table_offset);
+    write(ofs, uint32_t(m_all_glyphs.size()));
+    write(ofs, glyph_table_offset);
+    write(ofs, uint32_t(m_variations.size()));
+    write(ofs, variation_table_offset);
+    write(ofs, uint32_t(m_page_groups.size()));
+    write(ofs, page_group_table_offset);
+
+    ofs.seekp(file_size);
+}
+
+void GeneratedFont::export_as_bundle(const QString&            directory,
+                                     const FontExportOptions&  options,
+                                     ExportManifest&           manifest,
+                                     const FontExportProgress& progress) const
+{
+    namespace bf = bmfgen::binary_format;
+
+    const QString filename =
+        QDir::cleanPath(directory + QDir::separator() + m_name + ".bmfbundle");
+
+    std::ostringstream descriptor;
+    write_binary_descriptor(descriptor, QStringList(m_pages.size()));
+    const std::string descriptor_data = descriptor.str();
+
+    // The bundle is skipped before any page is encoded if nothing it consists of changed.
+    {
+        QCryptographicHash hash{QCryptographicHash::Md5};
+        hash.addData(QByteArrayView{descriptor_data});
+        hash.addData(options.compress_bundle_pages ? QByteArrayView{"z"} : QByteArrayView{"-"});
+        hash.addData(bundle_gray_format_to_string(options.bundle_gray_format).toLatin1());
+
+        for (const auto& page : m_pages)
+        {
+            hash.addData(page_export_key(page, m_all_glyphs, options));
+        }
+
+        if (!manifest.update(filename, hash.result().toHex()))
+        {
+            qDebug("Skipping unchanged file '%s'", qPrintable(filename));
+            return;
+        }
+    }
+
+    struct EncodedPage
+    {
+        bf::BundlePageEntry entry{};
+        QByteArray          data;
+        bool                is_valid{};
+    };
+
+    QList<qsizetype> page_indices(m_pages.size());
+    std::iota(page_indices.begin(), page_indices.end(), qsizetype(0));
+
+    const auto encode_page = [&](qsizetype index) {
+        EncodedPage     encoded;
+        const FontPage& page    = m_pages[index];
+        const bool      is_gray = is_exported_as_gray(page, options);
+
+        // Gray pages store coverage, i.e. the alpha of the rasterized levels, as C++ headers do.
+        // The luminance of a Grayscale8 conversion would be zero for dark fonts.
+        const QList<QImage> levels =
+            is_gray ? generate_page_levels(page, m_all_glyphs, options)
+                    : prepare_page_levels_for_export(page, m_all_glyphs, options);
+
+        if (levels.isEmpty() || levels.first().isNull())
+        {
+            return encoded;
+        }
+
+        const QImage& image = levels.first();
+        const int     bits  = is_gray ? bits_per_pixel(options.bundle_gray_format) : 32;
+
+        // QImage pads rows to 4 bytes, whereas bundles store them tightly packed. Mip levels
+        // follow the base level back to back, each with its own row pitch.
+        QByteArray   pixels;
+        QList<uchar> alpha_row;
+
+        for (const QImage& level : levels)
+        {
+            const qsizetype level_pitch = QtImageUtil::packed_row_pitch(level.width(), bits);
+            const qsizetype offset      = pixels.size();
+
+            pixels.resize(offset + level_pitch * level.height(), '\0');
+
+            for (int y = 0; y < level.height(); ++y)
+            {
+                auto* dst = reinterpret_cast<uchar*>(pixels.data() + offset + y * level_pitch);
+
+                if (is_gray)
+                {
+                    // Unprepared levels aren't flipped yet.
+                    const int src_y =
+                        options.flip_images_upside_down ? level.height() - 1 - y : y;
+                    const auto* src = reinterpret_cast<const QRgb*>(level.constScanLine(src_y));
+
+                    alpha_row.resize(level.width());
+
+                    for (int x = 0; x < level.width(); ++x)
+                    {
+                        alpha_row[x] = uchar(qAlpha(src[x]));
+                    }
+
+                    QtImageUtil::pack_gray_row(alpha_row.constData(), dst, level.width(), bits);
+                }
+                else
+                {
+                    std::memcpy(dst, level.constScanLine(y), level_pitch);
+                }
+            }
+        }
+
+        const bf::BundlePixelFormat pixel_format = [&] {
+            switch (bits)
+            {
+                case 8: return bf::BundlePixelFormat::Gray8;
+                case 4: return bf::BundlePixelFormat::Gray4;
+                case 1: return bf::BundlePixelFormat::Gray1;
+                default: break;
+            }
+
+            switch (rgba_export_layout(m_pages[index], options))
+            {
+                case PixelLayout::Rgba8888Premultiplied:
+                    return bf::BundlePixelFormat::Rgba8Premultiplied;
+                case PixelLayout::Rgba8888LinearPremultiplied:
+                    return bf::BundlePixelFormat::Rgba8LinearPremultiplied;
+                default: return bf::BundlePixelFormat::Rgba8;
+            }
+        }();
+
+        const qsizetype row_pitch = QtImageUtil::packed_row_pitch(image.width(), bits);
+
+        encoded.entry.width             = uint32_t(image.width());
+        encoded.entry.height            = uint32_t(image.height());
+        encoded.entry.row_pitch         = uint32_t(row_pitch);
+        encoded.entry.pixel_format      = pixel_format;
+        encoded.entry.level_count       = uint32_t(levels.size());
+        encoded.entry.uncompressed_size = uint64_t(pixels.size());
+
+        if (options.compress_bundle_pages)
+        {
+            // The fastest zlib level; qCompress prefixes the stream with the size (4 bytes).
+            encoded.data = qCompress(pixels, 1);
+            encoded.data.remove(0, 4);
+            encoded.entry.compression = bf::BundleCompression::Zlib;
+        }
+        else
+        {
+            encoded.data              = std::move(pixels);
+            encoded.entry.compression = bf::BundleCompression::None;
+        }
+
+        encoded.entry.data_size = uint64_t(encoded.data.size());
+        encoded.is_valid        = true;
+
+        return encoded;
+    };
+
+    const int        page_count = int(m_pages.size());
+    std::atomic<int> completed_page_count{0};
+
+    progress.report(FontExportStage::Pages, 0, page_count);
+
+    const auto encode_page_and_report = [&](qsizetype index) {
+        if (progress.is_canceled())
+        {
+            return EncodedPage{};
+        }
+
+        EncodedPage encoded = encode_page(index);
+        progress.report(FontExportStage::Pages, ++completed_page_count, page_count);
+
+        return encoded;
+    };
+
+    QList<EncodedPage> pages =
+        QtConcurrent::blockingMapped<QList<EncodedPage>>(page_indices, encode_page_and_report);
+
+    progress.throw_if_canceled();
+    progress.report(FontExportStage::Description, 0, 1);
+
+    for (qsizetype i = 0; i < pages.size(); ++i)
+    {
+        if (!pages[i].is_valid)
+        {
+            throw std::runtime_error{
+                QStringLiteral("Failed to prepare page %1 for export.").arg(i).toStdString()};
+        }
+    }
+
+    const auto align_up = [](uint64_t value) {
+        constexpr uint64_t alignment = bf::bundle_section_alignment;
+        return (value + alignment - 1) / alignment * alignment;
+    };
+
+    const uint64_t descriptor_offset = align_up(sizeof(bf::BundleHeader));
+    const uint64_t page_table_offset = align_up(descriptor_offset + descriptor_data.size());
+
+    uint64_t file_size = page_table_offset + pages.size() * sizeof(bf::BundlePageEntry);
+
+    for (auto& page : pages)
+    {
+        page.entry.data_offset = align_up(file_size);
+        file_size              = page.entry.data_offset + page.entry.data_size;
+    }
+
+    std::ofstream ofs{std::filesystem::path{filename.toStdU16String()},
+                      std::ios::binary | std::ios::trunc};
+
+    if (!ofs)
+    {
+        throw std::runtime_error(
+            QStringLiteral("Failed to open file '%1' for writing.").arg(filename).toStdString());
+    }
+
+    // Header
+    ofs.write(bf::bundle_magic.data(), bf::bundle_magic.size());
+    write(ofs, bf::bundle_version);
+    write(ofs, bf::bundle_section_alignment);
+    write(ofs, uint32_t(pages.size()));
+    write(ofs, descriptor_offset);
+    write(ofs, uint64_t(descriptor_data.size()));
+    write(ofs, page_table_offset);
+    write(ofs, file_size);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        write(ofs, uint32_t(0));
+    }
+
+    // Description
+    pad_to_alignment(ofs, bf::bundle_section_alignment);
+    ofs.write(descriptor_data.data(), std::streamsize(descriptor_data.size()));
+
+    // Page table
+    pad_to_alignment(ofs, bf::bundle_section_alignment);
+
+    for (const auto& page : pages)
+    {
+        write(ofs, page.entry.width);
+        write(ofs, page.entry.height);
+        write(ofs, page.entry.row_pitch);
+        write(ofs, uint32_t(page.entry.pixel_format));
+        write(ofs, uint32_t(page.entry.compression));
+        write(ofs, page.entry.level_count);
+        write(ofs, page.entry.data_offset);
+        write(ofs, page.entry.data_size);
+        write(ofs, page.entry.uncompressed_size);
+    }
+
+    // Page data
+    for (const auto& page : pages)
+    {
+        pad_to_alignment(ofs, bf::bundle_section_alignment);
+        ofs.write(page.data.constData(), page.data.size());
+    }
+
+    if (!ofs)
+    {
+        throw std::runtime_error(
+            QStringLiteral("Failed to write file '%1'.").arg(filename).toStdString());
+    }
+}
+
+struct HeaderPagePixels
+{
+    QByteArray pixels; // Tightly packed rows
+    qsizetype  row_pitch{};
+};
+
+// Converts a page to the pixel format of a C++ header.
+// RGBA8 pixels are stored in the specified layout (straight or premultiplied).
+// Rows are read bottom-up if flip_vertically is set.
+static HeaderPagePixels header_page_pixels(const QImage&     page_image,
+                                           HeaderPixelFormat format,
+                                           PixelLayout       rgba_layout,
+                                           bool              flip_vertically)
+{
+    const int width  = page_image.width();
+    const int height = page_image.height();
+
+    HeaderPagePixels result;
+    QByteArray&      pixels    = result.pixels;
+    qsizetype&       row_pitch = result.row_pitch;
+
+    switch (format)
+    {
+        case HeaderPixelFormat::Rgba8: {
+            row_pitch = qsizetype(width) * 4;
+            pixels    = QByteArray(row_pitch * height, Qt::Uninitialized);
+
+            for (int y = 0; y < height; ++y)
+            {
+                const int src_y = flip_vertically ? height - 1 - y : y;
+
+                QtImageUtil::convert_row(
+                    reinterpret_cast<const uint32_t*>(page_image.constScanLine(src_y)),
+                    reinterpret_cast<uchar*>(pixels.data() + y * row_pitch),
+                    width,
+                    rgba_layout);
+            }
+
+            break;
+        }
+        case HeaderPixelFormat::Gray8:
+        case HeaderPixelFormat::Gray4:
+        case HeaderPixelFormat::Gray1: {
+            const int bits = bits_per_pixel(format);
+
+            row_pitch = QtImageUtil::packed_row_pitch(width, bits);
+            pixels    = QByteArray(row_pitch * height, '\0');
+
+            QList<uchar> alpha_row(width);
+
+            for (int y = 0; y < height; ++y)
+            {
+                const int   src_y = flip_vertically ? height - 1 - y : y;
+                const auto* src   = reinterpret_cast<const QRgb*>(page_image.constScanLine(src_y));
+                auto*       dst   = reinterpret_cast<uchar*>(pixels.data() + y * row_pitch);
+
+                for (int x = 0; x < width; ++x)
+                {
+                    alpha_row[x] = uchar(qAlpha(src[x]));
+                }
+
+                QtImageUtil::pack_gray_row(alpha_row.constData(), dst, width, bits);
+            }
+
+            break;
+        }
+    }
+
+    return result;
+}
+
+// Turns a font name into a C++ identifier.
+static QString to_cpp_identifier(const QString& name)
+{
+    QString identifier;
+    identifier.reserve(name.size());
+
+    for (const QChar ch : name)
+    {
+        const char16_t c        = ch.unicode();
+        const bool     is_valid = (c >= u'a' && c <= u'z') || (c >= u'A' && c <= u'Z') ||
+                              (c >= u'0' && c <= u'9') || c == u'_';
+
+        identifier += is_valid ? ch : QChar(u'_');
+    }
+
+    if (identifier.isEmpty() || identifier.front().isDigit())
+    {
+        identifier.prepend(QStringLiteral("font_"));
+    }
+
+    return identifier;
+}
+
+void GeneratedFont::export_as_cpp_header(const QString&            directory,
+                                         const FontExportOptions&  options,
+                                         ExportManifest&           manifest,
+                                         const FontExportProgress& progress) const
+{
+    // Large initializers are slow to compile and some compilers limit their size, so page
+    // pixels are split into arrays of whole rows of at most this size.
+    constexpr qsizetype max_chunk_size = 64 * 1024;
+
+    // Number of array elements per line
+    constexpr int elements_per_line = 24;
+
+    constexpr char nl = '\n';
+
+    const QString filename = QDir::cleanPath(directory + QDir::separator() + m_name + ".hpp");
+
+    QByteArray contents;
+    QBuffer    buffer{&contents};
+    buffer.open(QIODevice::WriteOnly);
+
+    BufferedWriter w{&buffer};
+
+    const auto write_array_elements = [&w](const auto& values) {
+        qsizetype index = 0;
+
+        for (const auto value : values)
+        {
+            w << (index % elements_per_line == 0 ? "\n    " : " ") << value << ',';
+            ++index;
+        }
+
+        w << nl;
+    };
+
+    w << "// Generated by BMFGen from the font '" << m_name << "'. Do not edit." << nl;
+    w << nl;
+    w << "#pragma once" << nl;
+    w << nl;
+    w << "#include <array>" << nl;
+    w << "#include <cstddef>" << nl;
+    w << "#include <cstdint>" << nl;
+    w << nl;
+    w << "namespace bmfgen::" << to_cpp_identifier(m_name) << nl;
+    w << "{" << nl;
+
+    // Types
+    w << R"(enum class PixelFormat
+{
+    Rgba8, // 4 bytes per pixel, see AlphaMode
+    Gray8, // 1 byte per pixel, alpha (coverage) only
+    Gray4, // 4 bits per pixel, high nibble first; rows are padded to whole bytes
+    Gray1, // 1 bit per pixel, most significant bit first; rows are padded to whole bytes
+};
+
+// How the color channels of Rgba8 pixels relate to their alpha.
+enum class AlphaMode
+{
+    Straight,
+    Premultiplied,
+    LinearPremultiplied, // Premultiplied in linear space, then sRGB-encoded
+};
+
+struct Glyph
+{
+    std::uint32_t code_point;
+    std::uint16_t x;
+    std::uint16_t y;
+    std::uint16_t width;
+    std::uint16_t height;
+    std::uint16_t page_index;
+    std::int16_t  offset_x; // From the pen position (top of the line) to the top-left of the image
+    std::int16_t  offset_y;
+    std::int16_t  horizontal_advance;
+    std::int16_t  left_bearing;
+    std::int16_t  right_bearing;
+};
+
+struct Variation
+{
+    double               scale_factor;
+    int                  pixel_size;
+    int                  line_height;
+    int                  ascent;
+    int                  descent;
+    int                  line_gap;
+    int                  underline_position;
+    std::size_t          glyph_count;
+    const std::uint32_t* code_points;   // Sorted ascending, for binary search
+    const std::uint32_t* glyph_indices; // Indices into glyphs, parallel to code_points
+};
+
+// A run of consecutive rows of a page.
+struct PageChunk
+{
+    std::uint32_t       first_row;
+    std::uint32_t       row_count;
+    const std::uint8_t* pixels;
+};
+
+struct Page
+{
+    std::uint32_t    width;
+    std::uint32_t    height;
+    std::uint32_t    row_pitch; // In bytes
+    std::size_t      chunk_count;
+    const PageChunk* chunks;
+};
+
+)";
+
+    w << "inline constexpr char name[] = \"";
+
+    for (const QChar ch : m_name)
+    {
+        if (ch == '"' || ch == '\\')
+        {
+            w << '\\';
+        }
+
+        w << ch;
+    }
+
+    w << "\";" << nl;
+    w << "inline constexpr int base_size = " << m_base_size << ";" << nl;
+    w << "inline constexpr PixelFormat pixel_format = PixelFormat::" << [&] {
+        switch (options.header_pixel_format)
+        {
+            case HeaderPixelFormat::Rgba8: return "Rgba8";
+            case HeaderPixelFormat::Gray8: return "Gray8";
+            case HeaderPixelFormat::Gray4: return "Gray4";
+            case HeaderPixelFormat::Gray1: return "Gray1";
+        }
+
+        return "Rgba8";
+    }() << ";" << nl;
+    w << "inline constexpr AlphaMode alpha_mode = AlphaMode::" << [&] {
+        if (m_pages.isEmpty())
+        {
+            return "Straight";
+        }
+
+        switch (rgba_export_layout(m_pages.first(), options))
+        {
+            case PixelLayout::Rgba8888Premultiplied: return "Premultiplied";
+            case PixelLayout::Rgba8888LinearPremultiplied: return "LinearPremultiplied";
+            default: return "Straight";
+        }
+    }() << ";" << nl;
+    w << nl;
+
+    // Glyphs
+    w << "inline constexpr std::array<Glyph, " << m_all_glyphs.size() << "> glyphs{{" << nl;
+
+    for (const auto& glyph : m_all_glyphs)
+    {
+        w << "    {" << int(glyph.character.unicode()) << ", " << glyph.rect.x() << ", "
+          << glyph.rect.y() << ", " << glyph.rect.width() << ", " << glyph.rect.height() << ", "
+          << glyph.page_index << ", " << glyph.offset.x() << ", " << glyph.offset.y() << ", "
+          << glyph.horizontal_advance << ", " << glyph.left_bearing << ", "
+          << glyph.right_bearing << "}," << nl;
+    }
+
+    w << "}};" << nl;
+    w << nl;
+
+    // Variations: code point tables
+    for (qsizetype var_index = 0; var_index < m_variations.size(); ++var_index)
+    {
+        const Variation& variation = m_variations[var_index];
+
+        if (variation.glyph_indices.isEmpty())
+        {
+            continue;
+        }
+
+        QList<qsizetype> sorted_indices = variation.glyph_indices;
+
+        std::ranges::sort(sorted_indices, [this](qsizetype lhs, qsizetype rhs) {
+            return m_all_glyphs[lhs].character < m_all_glyphs[rhs].character;
+        });
+
+        QList<uint32_t> code_points;
+        code_points.reserve(sorted_indices.size());
+
+        for (const auto glyph_index : sorted_indices)
+        {
+            code_points.append(m_all_glyphs[glyph_index].character.unicode());
+        }
+
+        w << "inline constexpr std::uint32_t variation_" << var_index << "_code_points[] = {";
+        write_array_elements(code_points);
+        w << "};" << nl;
+        w << nl;
+
+        w << "inline constexpr std::uint32_t variation_" << var_index << "_glyph_indices[] = {";
+        write_array_elements(sorted_indices);
+        w << "};" << nl;
+        w << nl;
+    }
+
+    w << "inline constexpr std::array<Variation, " << m_variations.size() << "> variations{{"
+      << nl;
+
+    for (qsizetype var_index = 0; var_index < m_variations.size(); ++var_index)
+    {
+        const Variation& variation = m_variations[var_index];
+
+        w << "    {" << QString::number(variation.scale_factor, 'g', 17) << ", "
+          << variation.pixel_size() << ", " << variation.line_height << ", " << variation.ascent
+          << ", " << variation.descent << ", " << variation.line_gap << ", "
+          << variation.underline_position << ", " << variation.glyph_indices.size() << ", ";
+
+        if (variation.glyph_indices.isEmpty())
+        {
+            w << "nullptr, nullptr";
+        }
+        else
+        {
+            w << "variation_" << var_index << "_code_points, variation_" << var_index
+              << "_glyph_indices";
+        }
+
+        w << "}," << nl;
+    }
+
+    w << "}};" << nl;
+    w << nl;
+
+    // Pages
+    QList<qsizetype> row_pitches;
+    QList<int>       chunk_counts;
+
+    const int page_count = int(m_pages.size());
+
+    progress.report(FontExportStage::Pages, 0, page_count);
+
+    for (qsizetype page_index = 0; page_index < m_pages.size(); ++page_index)
+    {
+        progress.throw_if_canceled();
+
+        const FontPage& page  = m_pages[page_index];
+        const QImage&   image = page.image;
+
+        const auto [pixels, row_pitch] = header_page_pixels(image,
+                                                            options.header_pixel_format,
+                                                            rgba_export_layout(page, options),
+                                                            options.flip_images_upside_down);
+
+        const int rows_per_chunk =
+            row_pitch > 0 ? int(std::max(max_chunk_size / row_pitch, qsizetype(1))) : 1;
+
+        int chunk_count = 0;
+
+        for (int first_row = 0; first_row < image.height(); first_row += rows_per_chunk)
+        {
+            const int row_count = std::min(rows_per_chunk, image.height() - first_row);
+
+            const auto chunk = QByteArrayView{pixels}.sliced(first_row * row_pitch,
+                                                              row_count * row_pitch);
+
+            w << "inline constexpr std::uint8_t page_" << page_index << "_chunk_" << chunk_count
+              << "[] = {";
+            write_array_elements(std::span{reinterpret_cast<const uint8_t*>(chunk.data()),
+                                           size_t(chunk.size())});
+            w << "};" << nl;
+            w << nl;
+
+            ++chunk_count;
+        }
+
+        // Empty arrays are ill-formed, so pages without rows refer to no chunks at all.
+        if (chunk_count > 0)
+        {
+            w << "inline constexpr PageChunk page_" << page_index << "_chunks[] = {" << nl;
+
+            for (int chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+            {
+                const int first_row = chunk_index * rows_per_chunk;
+                const int row_count = std::min(rows_per_chunk, image.height() - first_row);
+
+                w << "    {" << first_row << ", " << row_count << ", page_" << page_index
+                  << "_chunk_" << chunk_index << "}," << nl;
+            }
+
+            w << "};" << nl;
+            w << nl;
+        }
+
+        row_pitches.append(row_pitch);
+        chunk_counts.append(chunk_count);
+
+        progress.report(FontExportStage::Pages, int(page_index) + 1, page_count);
+    }
+
+    progress.report(FontExportStage::Description, 0, 1);
+
+    w << "inline constexpr std::array<Page, " << m_pages.size() << "> pages{{" << nl;
+
+    for (qsizetype page_index = 0; page_index < m_pages.size(); ++page_index)
+    {
+        const QImage& image = m_pages[page_index].image;
+
+        w << "    {" << image.width() << ", " << image.height() << ", " << row_pitches[page_index]
+          << ", " << chunk_counts[page_index] << ", ";
+
+        if (chunk_counts[page_index] == 0)
+        {
+            w << "nullptr";
+        }
+        else
+        {
+            w << "page_" << page_index << "_chunks";
+        }
+
+        w << "}," << nl;
+    }
+
+    w << "}};" << nl;
+    w << nl;
+
+    // Lookup
+    w << R"(// Returns the glyph of a code point, or nullptr if the variation doesn't contain it.
+constexpr const Glyph* find_glyph(const Variation& variation, std::uint32_t code_point)
+{
+    std::size_t first = 0;
+    std::size_t last  = variation.glyph_count;
+
+    while (first < last)
+    {
+        const std::size_t middle = first + (last - first) / 2;
+
+        if (variation.code_points[middle] < code_point)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    if (first < variation.glyph_count && variation.code_points[first] == code_point)
+    {
+        return &glyphs[variation.glyph_indices[first]];
+    }
+
+    return nullptr;
+}
+)";
+
+    w << "} // namespace bmfgen::" << to_cpp_identifier(m_name) << nl;
+    w.flush();
+
+    write_file_if_changed(manifest, filename, contents);
+}
+
+QString GeneratedFont::bmfont_filename(const ExportArgs& args, qsizetype variation_index) const
+{
+    // A BMFont file describes a single font size, so each variation gets its own file.
+    const QString basename = m_variations.size() == 1
+                                 ? m_name
+                                 : QStringLiteral("%1_%2").arg(m_name).arg(variation_index);
+
+    return QDir::cleanPath(args.directory + QDir::separator() + basename + ".fnt");
+}
+
+void GeneratedFont::export_as_bmfont_text(const ExportArgs& args) const
+{
+    constexpr char nl = '\n';
+
+    for (qsizetype var_index = 0; var_index < m_variations.size(); ++var_index)
+    {
+        const Variation& variation = m_variations[var_index];
+        const QString    filename  = bmfont_filename(args, var_index);
+
+        QByteArray contents;
+        QBuffer    buffer{&contents};
+        buffer.open(QIODevice::WriteOnly);
+
+        BufferedWriter w{&buffer};
+
+        const QSize page_size = bmfont_page_size(m_pages);
+
+        const auto [alpha_chnl, red_chnl, green_chnl, blue_chnl] =
+            bmfont_channel_contents(m_pages);
+
+        w << "info face=\"" << m_name << "\" size=" << variation.pixel_size()
+          << " bold=0 italic=0 charset=\"\" unicode=1 stretchH=100"
+          << " smooth=" << int(m_is_anti_aliased) << " aa=1"
+          << " padding=0,0,0,0 spacing=0,0 outline=" << m_outline_thickness << nl;
+
+        w << "common lineHeight=" << variation.line_height << " base=" << variation.ascent
+          << " scaleW=" << page_size.width() << " scaleH=" << page_size.height()
+          << " pages=" << m_pages.size() << " packed=" << int(has_channel_packed_pages(m_pages))
+          << " alphaChnl=" << int(alpha_chnl) << " redChnl=" << int(red_chnl)
+          << " greenChnl=" << int(green_chnl) << " blueChnl=" << int(blue_chnl) << nl;
+
+        for (qsizetype i = 0; i < m_pages.size(); ++i)
+        {
+            w << "page id=" << i << " file=\"" << QFileInfo{args.images_filenames.at(i)}.fileName()
+              << "\"" << nl;
+        }
+
+        w << "chars count=" << variation.glyph_indices.size() << nl;
+
+        for (const auto glyph_index : variation.glyph_indices)
+        {
+            const Glyph& glyph = m_all_glyphs[glyph_index];
+
+            w << "char id=" << int(glyph.character.unicode()) << " x=" << glyph.rect.x()
+              << " y=" << glyph.rect.y() << " width=" << glyph.rect.width()
+              << " height=" << glyph.rect.height() << " xoffset=" << glyph.offset.x()
+              << " yoffset=" << glyph.offset.y() << " xadvance=" << glyph.horizontal_advance
+              << " page=" << glyph.page_index << " chnl=" << int(bmfont_channel(glyph)) << nl;
+        }
+
+        w << "kernings count=" << variation.kerning_pairs.size() << nl;
+
+        for (const KerningPair& pair : variation.kerning_pairs)
+        {
+            w << "kerning first=" << int(pair.first.unicode())
+              << " second=" << int(pair.second.unicode()) << " amount=" << pair.amount << nl;
+        }
+
+        w.flush();
+
+        write_file_if_changed(*args.manifest, filename, contents);
+    }
+}
+
+void GeneratedFont::export_as_bmfont_binary(const ExportArgs& args) const
+{
+    // Writes a block: type, size of the data that follows, data.
+    const auto write_block = [](std::ostream& ofs, uint8_t type, const std::ostringstream& data) {
+        const std::string bytes = data.str();
+        write(ofs, type);
+        write(ofs, uint32_t(bytes.size()));
+        ofs.write(bytes.data(), std::streamsize(bytes.size()));
+    };
+
+    const QSize page_size = bmfont_page_size(m_pages);
+
+    for (qsizetype var_index = 0; var_index < m_variations.size(); ++var_index)
+    {
+        const Variation& variation = m_variations[var_index];
+        const QString    filename  = bmfont_filename(args, var_index);
+
+        std::ostringstream ofs;
+
+        ofs.write("BMF\x03", 4);
+
+        // Info
+        {
+            constexpr uint8_t smooth_bit  = 1 << 0;
+            constexpr uint8_t unicode_bit = 1 << 1;
+
+            std::ostringstream block;
+            write(block, int16_t(variation.pixel_size()));
+            write(block, uint8_t((m_is_anti_aliased ? smooth_bit : 0) | unicode_bit));
+            write(block, uint8_t(0));    // charSet
+            write(block, uint16_t(100)); // stretchH
+            write(block, uint8_t(1));    // aa
+
+            for (int i = 0; i < 6; ++i) // padding (4), spacing (2)
+            {
+                write(block, uint8_t(0));
+            }
+
+            write(block, uint8_t(m_outline_thickness)); // outline
+
+            const QByteArray face = m_name.toUtf8();
+            block.write(face.constData(), face.size());
+            block.put('\0');
+
+            write_block(ofs, 1, block);
+        }
+
+        // Common
+        {
+            std::ostringstream block;
+            write(block, uint16_t(variation.line_height));
+            write(block, uint16_t(variation.ascent));
+            write(block, uint16_t(page_size.width()));
+            write(block, uint16_t(page_size.height()));
+            write(block, uint16_t(m_pages.size()));
+            constexpr uint8_t packed_bit = 1 << 7;
+
+            write(block, uint8_t(has_channel_packed_pages(m_pages) ? packed_bit : 0)); // bitField
+
+            // Alpha, red, green, blue
+            for (const uint8_t contents : bmfont_channel_contents(m_pages))
+            {
+                write(block, contents);
+            }
+
+            write_block(ofs, 2, block);
+        }
+
+        // Pages
+        {
+            std::ostringstream block;
+
+            for (const auto& image_filename : args.images_filenames)
+            {
+                const QByteArray name = QFileInfo{image_filename}.fileName().toUtf8();
+                block.write(name.constData(), name.size());
+                block.put('\0');
+            }
+
+            write_block(ofs, 3, block);
+        }
+
+        // Chars
+        {
+            std::ostringstream block;
+
+            for (const auto glyph_index : variation.glyph_indices)
+            {
+                const Glyph& glyph = m_all_glyphs[glyph_index];
+
+                write(block, uint32_t(glyph.character.unicode()));
+                write(block, uint16_t(glyph.rect.x()));
+                write(block, uint16_t(glyph.rect.y()));
+                write(block, uint16_t(glyph.rect.width()));
+                write(block, uint16_t(glyph.rect.height()));
+                write(block, int16_t(glyph.offset.x()));
+                write(block, int16_t(glyph.offset.y()));
+                write(block, int16_t(glyph.horizontal_advance));
+                write(block, uint8_t(glyph.page_index));
+                write(block, bmfont_channel(glyph));
+            }
+
+            write_block(ofs, 4, block);
+        }
+
+        // Kerning pairs (optional)
+        if (!variation.kerning_pairs.isEmpty())
+        {
+            std::ostringstream block;
+
+            for (const KerningPair& pair : variation.kerning_pairs)
+            {
+                write(block, uint32_t(pair.first.unicode()));
+                write(block, uint32_t(pair.second.unicode()));
+                write(block, int16_t(pair.amount));
+            }
+
+            write_block(ofs, 5, block);
+        }
+
+        write_file_if_changed(*args.manifest, filename, QByteArray::fromStdString(ofs.str()));
+    }
 }
 
 inline void hash_combine(std::size_t&)
@@ -625,7 +2917,8 @@ uint64_t GeneratedFont::build_cache_key() const
                  m_chars.size(),
                  m_all_glyphs.size(),
                  m_variations.size(),
-                 m_pages.size());
+                 m_pages.size(),
+                 m_page_groups.size());
 
     for (const auto& var : m_variations)
     {
@@ -636,7 +2929,8 @@ uint64_t GeneratedFont::build_cache_key() const
                      var.descent,
                      var.line_gap,
                      var.underline_position,
-                     var.glyph_indices.size());
+                     var.glyph_indices.size(),
+                     var.kerning_pairs.size());
     }
 
     for (const auto& page : m_pages)
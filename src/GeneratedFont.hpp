@@ -6,25 +6,131 @@
 
 #include "FontPage.hpp"
 #include "Glyph.hpp"
+#include "PageGroup.hpp"
+#include "PngEncoder.hpp"
 #include <QSet>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+
+class ExportManifest;
 
 enum class FontDescriptionType
 {
     JSON,
     XML,
     Text,
+    Binary,
+    BMFontText,
+    BMFontBinary,
+    Bundle,
+    CppHeader,
 };
 
 enum class FontExportImageType
 {
     Png,
     Bmp,
+    Dds,  // BC4 for monochromatic pages, BC7 otherwise
+    Ktx2, // BC4 for monochromatic pages, BC7 otherwise
+    Qoi,  // Lossless, decodes faster than PNG
+};
+
+// Whether RGBA pages are exported with straight or premultiplied alpha. Pages are rasterized
+// premultiplied in sRGB space; Linear premultiplies in linear space and then sRGB-encodes, which
+// suits renderers that sample pages from sRGB textures.
+enum class PremultipliedAlpha
+{
+    None,
+    Srgb,
+    Linear,
+};
+
+// The pixel formats of pages that are embedded in a C++ header.
+enum class HeaderPixelFormat
+{
+    Rgba8, // Straight alpha
+    Gray8, // Alpha (coverage) only
+    Gray4, // Alpha rounded to 4 bits, 2 pixels per byte, high nibble first
+    Gray1, // Alpha thresholded at 50%, 8 pixels per byte, most significant bit first
+};
+
+// The pixel formats of monochromatic pages in bundles, for targets that can't spare 8 bits per
+// pixel. Like the gray formats of C++ headers, they store coverage (alpha), regardless of the
+// color of the font. Gray1 is lossless for fonts without anti-aliasing.
+enum class BundleGrayFormat
+{
+    Gray8, // Alpha (coverage) only
+    Gray4, // Alpha rounded to 4 bits, 2 pixels per byte, high nibble first
+    Gray1, // Alpha thresholded at 50%, 8 pixels per byte, most significant bit first
+};
+
+// Settings that determine how a generated font is written to disk.
+struct FontExportOptions
+{
+    FontDescriptionType description_type{};
+    FontExportImageType image_type{};
+    bool                flip_images_upside_down{};
+    PremultipliedAlpha  premultiplied_alpha{};
+    bool                allow_monochromatic_images{};
+    PngEncoderOptions   png;
+    bool                compress_bundle_pages{};
+    bool                compact_descriptors{}; // Attribute-based XML, columnar JSON
+    HeaderPixelFormat   header_pixel_format{};
+    BundleGrayFormat    bundle_gray_format{};
+    bool                pack_monochromatic_pages{}; // Up to 4 pages per RGBA page, one per channel
+    bool                generate_mipmaps{};         // Not supported by C++ headers
+};
+
+// The stages of an export, in the order in which they run.
+enum class FontExportStage
+{
+    Generating,  // Rasterizing and packing the glyphs
+    Pages,       // Converting and encoding the pages, one step per page
+    Description, // Writing the description (and the pages, for bundles and C++ headers)
+};
+
+// Observes an export and allows canceling it. Both functions are called from the threads that
+// perform the export, possibly concurrently, and either of them may be empty.
+struct FontExportProgress
+{
+    std::function<void(FontExportStage stage, int completed, int total)> on_progress;
+    std::function<bool()>                                                cancel_requested;
+
+    void report(FontExportStage stage, int completed, int total) const;
+
+    bool is_canceled() const;
+
+    // Throws ExportCanceledError if the export was canceled.
+    void throw_if_canceled() const;
+};
+
+class ExportCanceledError : public std::runtime_error
+{
+  public:
+    explicit ExportCanceledError()
+        : runtime_error("The export was canceled.")
+    {
+    }
 };
 
 extern FontExportImageType font_export_image_type_from_string(const QString& value);
 
 extern QString font_export_image_type_to_string(FontExportImageType type);
 
+extern PremultipliedAlpha premultiplied_alpha_from_string(const QString& value);
+
+extern QString premultiplied_alpha_to_string(PremultipliedAlpha value);
+
+extern HeaderPixelFormat header_pixel_format_from_string(const QString& value);
+
+extern QString header_pixel_format_to_string(HeaderPixelFormat value);
+
+extern BundleGrayFormat bundle_gray_format_from_string(const QString& value);
+
+extern QString bundle_gray_format_to_string(BundleGrayFormat value);
+
 class GeneratedFont final
 {
   public:
@@ -35,42 +141,59 @@ class GeneratedFont final
 
         int pixel_size() const;
 
-        GeneratedFont*   parent_font{};
-        double           scale_factor{};
-        int              line_height{};
-        int              ascent{};
-        int              descent{};
-        int              line_gap{};
-        int              underline_position{};
-        QList<qsizetype> glyph_indices;
+        GeneratedFont*     parent_font{};
+        double             scale_factor{};
+        int                line_height{};
+        int                ascent{};
+        int                descent{};
+        int                line_gap{};
+        int                underline_position{};
+        QList<qsizetype>   glyph_indices;
+        QList<KerningPair> kerning_pairs; // Empty unless kerning is enabled
     };
 
     GeneratedFont() = default;
 
     GeneratedFont(QString          name,
                   int              base_size,
+                  bool             is_anti_aliased,
+                  int              outline_thickness,
                   QSet<QChar>      chars,
                   QList<Glyph>     all_glyphs,
                   QList<Variation> variations,
-                  QList<FontPage>  pages);
+                  QList<FontPage>  pages,
+                  QList<PageGroup> page_groups);
 
     bool has_char(QChar character) const;
 
     int base_size() const;
 
+    bool is_anti_aliased() const;
+
+    // The width of the stroke around glyphs in pixels, or zero if they aren't outlined.
+    int outline_thickness() const;
+
     const QList<Glyph>& all_glyphs() const;
 
     const QList<FontPage>& pages() const;
 
     const FontPage& page_at(int index) const;
 
-    void export_to_disk(const QString&      directory,
-                        FontDescriptionType font_description_type,
-                        FontExportImageType image_type,
-                        bool                flip_images_upside_down,
-                        bool                allow_monochromatic_images) const;
+    const QList<PageGroup>& page_groups() const;
 
-    qsizetype size_in_bytes(bool allow_monochromatic_images) const;
+    // Throws ExportCanceledError if canceled via progress. The manifest is not updated then, so
+    // that the next export rewrites any file that was only partially written.
+    void export_to_disk(const QString&            directory,
+                        const FontExportOptions&  options,
+                        const FontExportProgress& progress = {}) const;
+
+    // Returns a copy of the font in which runs of up to four consecutive monochromatic pages
+    // (of the same page group) are packed into the R, G, B and A channels of a single page.
+    // Each channel holds the coverage (alpha) of one page; Glyph::channel tells which.
+    std::shared_ptr<GeneratedFont> with_channel_packed_pages() const;
+
+    // The size of the pixel data of all pages as they are exported with the specified options.
+    qsizetype size_in_bytes(const FontExportOptions& options) const;
 
     qsizetype total_glyph_count() const;
 
@@ -83,29 +206,65 @@ class GeneratedFont final
     const Variation& variation_by_scale(double scale) const;
 
   private:
-    std::optional<QStringList> export_images(const QString&      directory,
-                                             FontExportImageType type,
-                                             bool                flip_upside_down,
-                                             bool                allow_monochromatic) const;
+    // The number of consecutive pages that with_channel_packed_pages() packs into each of its
+    // pages, in page order. Pages that aren't packed form runs of one.
+    QList<qsizetype> channel_packing_runs() const;
+
+    // Throws if any page fails to export, listing every failed page.
+    // Pages that are unchanged since the last export (as recorded by the manifest) are skipped.
+    QStringList export_images(const QString&            directory,
+                              const FontExportOptions&  options,
+                              bool                      pad_page_numbers,
+                              ExportManifest&           manifest,
+                              const FontExportProgress& progress) const;
 
     struct ExportArgs
     {
-        QString     directory;
-        QStringList images_filenames;
+        QString         directory;
+        QStringList     images_filenames;
+        ExportManifest* manifest{};
+        bool            compact_schema{};
     };
 
     void export_as_json(const ExportArgs& args) const;
 
     void export_as_xml(const ExportArgs& args) const;
 
+    void export_as_compact_xml(const ExportArgs& args) const;
+
     void export_as_text(const ExportArgs& args) const;
 
+    void export_as_binary(const ExportArgs& args) const;
+
+    void write_binary_descriptor(std::ostream& ofs, const QStringList& page_names) const;
+
+    void export_as_bundle(const QString&            directory,
+                          const FontExportOptions&  options,
+                          ExportManifest&           manifest,
+                          const FontExportProgress& progress) const;
+
+    // Writes a header with the glyph metrics and page pixels as constexpr data, so that the font
+    // can be compiled into an application.
+    void export_as_cpp_header(const QString&            directory,
+                              const FontExportOptions&  options,
+                              ExportManifest&           manifest,
+                              const FontExportProgress& progress) const;
+
+    void export_as_bmfont_text(const ExportArgs& args) const;
+
+    void export_as_bmfont_binary(const ExportArgs& args) const;
+
+    QString bmfont_filename(const ExportArgs& args, qsizetype variation_index) const;
+
     uint64_t build_cache_key() const;
 
     QString          m_name;
     int              m_base_size = 0;
+    bool             m_is_anti_aliased = true;
+    int              m_outline_thickness = 0;
     QSet<QChar>      m_chars;
     QList<Glyph>     m_all_glyphs;
     QList<Variation> m_variations;
     QList<FontPage>  m_pages;
+    QList<PageGroup> m_page_groups;
 };
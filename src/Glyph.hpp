@@ -11,8 +11,19 @@ struct Glyph
     QChar  character;
     QRect  rect;
     int    page_index{};
+    QPoint offset; // From the pen position (top of the line) to the top-left of the image
     int    horizontal_advance{};
     int    left_bearing{};
     int    right_bearing{};
+    int    frequency_rank{-1}; // Rank in the text corpus (0 = most frequent), -1 if absent
+    int    channel{-1};        // 0 = R ... 3 = A in a channel-packed page, -1 otherwise
     QImage image;
 };
+
+// The adjustment of the advance of a glyph that is followed by another one.
+struct KerningPair
+{
+    QChar first;
+    QChar second;
+    int   amount{}; // In pixels, added to the horizontal advance of the first glyph
+};
@@ -0,0 +1,188 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "JsonStreamWriter.hpp"
+
+#include <QLocale>
+#include <cmath>
+
+static constexpr std::string_view indentation = "    ";
+
+JsonStreamWriter::JsonStreamWriter(QIODevice* device)
+    : m_out(device)
+{
+}
+
+void JsonStreamWriter::begin_object()
+{
+    begin_container({}, '{', false);
+}
+
+void JsonStreamWriter::begin_object(std::string_view key)
+{
+    begin_container(key, '{', false);
+}
+
+void JsonStreamWriter::end_object()
+{
+    end_container('}');
+}
+
+void JsonStreamWriter::begin_array()
+{
+    begin_container({}, '[', false);
+}
+
+void JsonStreamWriter::begin_array(std::string_view key)
+{
+    begin_container(key, '[', false);
+}
+
+void JsonStreamWriter::begin_inline_array(std::string_view key)
+{
+    begin_container(key, '[', true);
+}
+
+void JsonStreamWriter::end_array()
+{
+    end_container(']');
+}
+
+void JsonStreamWriter::write(std::string_view key, QStringView value)
+{
+    begin_value(key);
+    write_string(value);
+}
+
+void JsonStreamWriter::write(std::string_view key, double value)
+{
+    begin_value(key);
+
+    if (!std::isfinite(value))
+    {
+        // Same as QJsonDocument
+        m_out << "null";
+        return;
+    }
+
+    m_out.write(std::string_view{QByteArray::number(value, 'g', QLocale::FloatingPointShortest)});
+}
+
+void JsonStreamWriter::flush()
+{
+    Q_ASSERT(m_containers.isEmpty());
+    m_out.write('\n');
+    m_out.flush();
+}
+
+void JsonStreamWriter::begin_value(std::string_view key)
+{
+    if (m_containers.isEmpty())
+    {
+        return;
+    }
+
+    Container& container = m_containers.last();
+
+    if (container.has_elements)
+    {
+        m_out.write(',');
+    }
+
+    container.has_elements = true;
+
+    if (container.is_inline)
+    {
+        return;
+    }
+
+    m_out.write('\n');
+
+    for (qsizetype i = 0; i < m_containers.size(); ++i)
+    {
+        m_out.write(indentation);
+    }
+
+    if (!key.empty())
+    {
+        m_out.write('"');
+        m_out.write(key);
+        m_out.write(std::string_view{"\": "});
+    }
+}
+
+void JsonStreamWriter::begin_container(std::string_view key, char bracket, bool is_inline)
+{
+    begin_value(key);
+    m_out.write(bracket);
+    m_containers.append(Container{.is_inline = is_inline});
+}
+
+void JsonStreamWriter::end_container(char bracket)
+{
+    Q_ASSERT(!m_containers.isEmpty());
+
+    const Container container = m_containers.takeLast();
+
+    if (container.has_elements && !container.is_inline)
+    {
+        m_out.write('\n');
+
+        for (qsizetype i = 0; i < m_containers.size(); ++i)
+        {
+            m_out.write(indentation);
+        }
+    }
+
+    m_out.write(bracket);
+}
+
+void JsonStreamWriter::write_string(QStringView value)
+{
+    static constexpr char hex_digits[] = "0123456789abcdef";
+
+    m_out.write('"');
+
+    qsizetype run_start = 0;
+
+    const auto flush_run = [&](qsizetype end) {
+        if (end > run_start)
+        {
+            m_out.write(value.sliced(run_start, end - run_start));
+        }
+    };
+
+    for (qsizetype i = 0; i < value.size(); ++i)
+    {
+        const char16_t ch = value[i].unicode();
+
+        if (ch >= 0x20 && ch != '"' && ch != '\\')
+        {
+            continue;
+        }
+
+        flush_run(i);
+        run_start = i + 1;
+
+        switch (ch)
+        {
+            case '"': m_out << "\\\""; break;
+            case '\\': m_out << "\\\\"; break;
+            case '\b': m_out << "\\b"; break;
+            case '\f': m_out << "\\f"; break;
+            case '\n': m_out << "\\n"; break;
+            case '\r': m_out << "\\r"; break;
+            case '\t': m_out << "\\t"; break;
+            default:
+                m_out << "\\u00";
+                m_out.write(hex_digits[ch >> 4]);
+                m_out.write(hex_digits[ch & 0xF]);
+                break;
+        }
+    }
+
+    flush_run(value.size());
+
+    m_out.write('"');
+}
@@ -0,0 +1,75 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include "BufferedWriter.hpp"
+#include <QList>
+
+// Writes indented JSON directly to a device, without building a QJsonObject tree first.
+// Keys are written in the order in which they are passed and are expected to be plain
+// ASCII identifiers; string values are escaped.
+class JsonStreamWriter final
+{
+  public:
+    explicit JsonStreamWriter(QIODevice* device);
+
+    void begin_object();
+
+    void begin_object(std::string_view key);
+
+    void end_object();
+
+    void begin_array();
+
+    void begin_array(std::string_view key);
+
+    // Begins an array whose elements are written on a single line, without whitespace.
+    // This suits long arrays of numbers.
+    void begin_inline_array(std::string_view key);
+
+    void end_array();
+
+    void write(std::string_view key, QStringView value);
+
+    void write(std::string_view key, double value);
+
+    template <std::integral T>
+        requires(!std::same_as<T, bool>)
+    void write(std::string_view key, T value)
+    {
+        begin_value(key);
+        m_out << value;
+    }
+
+    // Writes an array element.
+    template <std::integral T>
+        requires(!std::same_as<T, bool>)
+    void write_element(T value)
+    {
+        begin_value({});
+        m_out << value;
+    }
+
+    // Finishes the document and throws if the device can't be written to.
+    void flush();
+
+  private:
+    void begin_value(std::string_view key);
+
+    void begin_container(std::string_view key, char bracket, bool is_inline);
+
+    void end_container(char bracket);
+
+    void write_string(QStringView value);
+
+    struct Container
+    {
+        bool has_elements{};
+        bool is_inline{};
+    };
+
+    BufferedWriter   m_out;
+    QList<Container> m_containers;
+};
@@ -1,5 +1,8 @@
 #include "MaxRectsBinPack.hpp"
 
+#include <algorithm>
+#include <set>
+
 namespace binpacking
 {
 bool is_contained_in(const QRect& a, const QRect& b)
@@ -8,44 +11,75 @@ bool is_contained_in(const QRect& a, const QRect& b)
            a.y() + a.height() <= b.y() + b.height();
 }
 
-bool DisjointRectCollection::add(const QRect& r)
+std::optional<std::pair<qsizetype, qsizetype>> find_overlapping_rects(const QList<QRect>& rects)
 {
-    // Degenerate rectangles are ignored.
-    if (r.width() == 0 || r.height() == 0)
+    struct Event
     {
-        return true;
-    }
+        int       x;
+        bool      is_start;
+        qsizetype rect_index;
+    };
 
-    if (!disjoint(r))
+    QList<Event> events;
+    events.reserve(rects.size() * 2);
+
+    for (qsizetype i = 0; i < rects.size(); ++i)
     {
-        return false;
+        const QRect& r = rects[i];
+
+        if (r.width() <= 0 || r.height() <= 0)
+        {
+            continue;
+        }
+
+        events.push_back(Event{.x = r.x(), .is_start = true, .rect_index = i});
+        events.push_back(Event{.x = r.x() + r.width(), .is_start = false, .rect_index = i});
     }
 
-    rects.push_back(r);
-    return true;
-}
+    // Ends are processed before starts at the same position, so that touching rectangles
+    // don't count as overlapping.
+    std::ranges::sort(events, [](const Event& a, const Event& b) {
+        return a.x != b.x ? a.x < b.x : !a.is_start && b.is_start;
+    });
 
-void DisjointRectCollection::clear()
-{
-    rects.clear();
-}
+    // The rectangles that intersect the sweep line, ordered by their vertical start.
+    // As long as no overlap was found, their vertical intervals are disjoint. A new interval
+    // therefore overlaps an active one if and only if it overlaps one of its two neighbors.
+    std::set<std::pair<int, qsizetype>> active;
 
-bool DisjointRectCollection::disjoint(const QRect& r) const
-{
-    if (r.width() == 0 || r.height() == 0)
-        return true;
+    for (const Event& event : events)
+    {
+        const QRect& r   = rects[event.rect_index];
+        const auto   key = std::pair{r.y(), event.rect_index};
 
-    for (qsizetype i = 0; i < rects.size(); ++i)
-        if (!disjoint(rects[i], r))
-            return false;
+        if (!event.is_start)
+        {
+            active.erase(key);
+            continue;
+        }
 
-    return true;
-}
+        const auto next = active.lower_bound(key);
 
-bool DisjointRectCollection::disjoint(const QRect& a, const QRect& b)
-{
-    return a.x() + a.width() <= b.x() || b.x() + b.width() <= a.x() ||
-           a.y() + a.height() <= b.y() || b.y() + b.height() <= a.y();
+        if (next != active.end() && next->first < r.y() + r.height())
+        {
+            return std::pair{next->second, event.rect_index};
+        }
+
+        if (next != active.begin())
+        {
+            const auto   prev      = std::prev(next);
+            const QRect& prev_rect = rects[prev->second];
+
+            if (prev_rect.y() + prev_rect.height() > r.y())
+            {
+                return std::pair{prev->second, event.rect_index};
+            }
+        }
+
+        active.insert(next, key);
+    }
+
+    return std::nullopt;
 }
 
 MaxRectsBinPack::MaxRectsBinPack(QSize size)
@@ -12,22 +12,14 @@
 #include <QList>
 #include <QRect>
 #include <QSize>
+#include <optional>
 
 namespace binpacking
 {
-class DisjointRectCollection
-{
-  public:
-    bool add(const QRect& r);
-
-    void clear();
-
-    bool disjoint(const QRect& r) const;
-
-    static bool disjoint(const QRect& a, const QRect& b);
-
-    QList<QRect> rects;
-};
+// Finds a pair of overlapping rectangles using a sweep line, in O(n log n).
+// Rectangles that merely touch are not considered to overlap, and empty rectangles are ignored.
+// Returns the indices of the first overlapping pair that was found, if any.
+std::optional<std::pair<qsizetype, qsizetype>> find_overlapping_rects(const QList<QRect>& rects);
 
 class MaxRectsBinPack
 {
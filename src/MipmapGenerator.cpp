@@ -0,0 +1,300 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "MipmapGenerator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define BMFGEN_HAS_SSE2
+#endif
+
+static constexpr int no_owner = -1;
+
+static constexpr int all_channels = 0xF;
+
+// Owners (region indices) of the pixels of a level, tracked for the channels of a mask.
+struct OwnerMap
+{
+    int        channel_mask{};
+    QList<int> owners;
+};
+
+// Filters the masked channels of a pixel from up to four samples, of which only those of the
+// specified owner count.
+static void filter_pixel(const std::array<const uchar*, 4>& samples,
+                         const std::array<int, 4>&          owners,
+                         int                                owner,
+                         int                                channel_mask,
+                         uchar*                             dst)
+{
+    for (int c = 0; c < 4; ++c)
+    {
+        if ((channel_mask & (1 << c)) == 0)
+        {
+            continue;
+        }
+
+        int sum = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (owners[i] == owner)
+            {
+                sum += samples[i][c];
+            }
+        }
+
+        dst[c] = uchar((sum + 2) >> 2);
+    }
+}
+
+// Returns the owner that occurs most among the samples, preferring regions over no region.
+static int majority_owner(const std::array<int, 4>& owners)
+{
+    int best       = no_owner;
+    int best_count = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        if (owners[i] == no_owner)
+        {
+            continue;
+        }
+
+        const int count = int(std::count(owners.begin(), owners.end(), owners[i]));
+
+        if (count > best_count)
+        {
+            best       = owners[i];
+            best_count = count;
+        }
+    }
+
+    return best;
+}
+
+#ifdef BMFGEN_HAS_SSE2
+// Box-filters two rows of 8 pixels into 4 pixels.
+static inline __m128i box_filter_4(const uchar* row0, const uchar* row1)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0));
+    const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 16));
+    const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1));
+    const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 16));
+
+    // Vertical sums of pixel pairs, 16 bits per channel.
+    const __m128i p01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+    const __m128i p23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+    const __m128i p45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+    const __m128i p67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+    // Horizontal sums of the pairs.
+    const __m128i q01 = _mm_add_epi16(_mm_unpacklo_epi64(p01, p23), _mm_unpackhi_epi64(p01, p23));
+    const __m128i q23 = _mm_add_epi16(_mm_unpacklo_epi64(p45, p67), _mm_unpackhi_epi64(p45, p67));
+
+    const __m128i two = _mm_set1_epi16(2);
+
+    return _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(q01, two), 2),
+                            _mm_srli_epi16(_mm_add_epi16(q23, two), 2));
+}
+
+// Returns whether 8 owners of each of two rows are all equal to the first one.
+static inline bool is_single_owner_block(const int* owners0, const int* owners1)
+{
+    const __m128i first = _mm_set1_epi32(owners0[0]);
+
+    const __m128i eq = _mm_and_si128(
+        _mm_and_si128(
+            _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(owners0)), first),
+            _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(owners0 + 4)),
+                            first)),
+        _mm_and_si128(
+            _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(owners1)), first),
+            _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(owners1 + 4)),
+                            first)));
+
+    return _mm_movemask_epi8(eq) == 0xFFFF;
+}
+#endif
+
+// Filters the masked channels of a level into the next smaller one, using the ownership of a
+// single owner map.
+static void filter_level(const QImage&     src,
+                         const QList<int>& owners,
+                         int               channel_mask,
+                         QImage&           dst,
+                         QList<int>&       dst_owners)
+{
+    const int width      = src.width();
+    const int height     = src.height();
+    const int dst_width  = dst.width();
+    const int dst_height = dst.height();
+
+#ifdef BMFGEN_HAS_SSE2
+    // Selects the bytes of the masked channels of four pixels.
+    uint32_t pixel_mask = 0;
+
+    for (int c = 0; c < 4; ++c)
+    {
+        if ((channel_mask & (1 << c)) != 0)
+        {
+            pixel_mask |= 0xFFu << (c * 8);
+        }
+    }
+
+    const __m128i byte_mask = _mm_set1_epi32(int(pixel_mask));
+#endif
+
+    for (int y = 0; y < dst_height; ++y)
+    {
+        // Sizes are halved rounding down, so the last row and column of odd sizes are
+        // dropped. A size of 1 stays 1 and repeats its only row or column instead.
+        const int y0 = std::min(y * 2, height - 1);
+        const int y1 = std::min(y * 2 + 1, height - 1);
+
+        const uchar* row0          = src.constScanLine(y0);
+        const uchar* row1          = src.constScanLine(y1);
+        const int*   owner_row0    = owners.constData() + qsizetype(y0) * width;
+        const int*   owner_row1    = owners.constData() + qsizetype(y1) * width;
+        uchar*       dst_row       = dst.scanLine(y);
+        int*         dst_owner_row = dst_owners.data() + qsizetype(y) * dst_width;
+
+        for (int x = 0; x < dst_width; ++x)
+        {
+#ifdef BMFGEN_HAS_SSE2
+            // Most blocks lie within a single glyph (or in between glyphs), which needs no
+            // per-pixel ownership.
+            if (x % 4 == 0 && x + 4 <= dst_width && x * 2 + 8 <= width &&
+                is_single_owner_block(owner_row0 + x * 2, owner_row1 + x * 2))
+            {
+                auto* dst_pixels = reinterpret_cast<__m128i*>(dst_row + x * 4);
+
+                __m128i filtered = box_filter_4(row0 + x * 8, row1 + x * 8);
+
+                if (channel_mask != all_channels)
+                {
+                    // Channels of other owner maps are kept.
+                    filtered = _mm_or_si128(
+                        _mm_and_si128(filtered, byte_mask),
+                        _mm_andnot_si128(byte_mask, _mm_loadu_si128(dst_pixels)));
+                }
+
+                _mm_storeu_si128(dst_pixels, filtered);
+
+                std::fill_n(dst_owner_row + x, 4, owner_row0[x * 2]);
+                x += 3;
+                continue;
+            }
+#endif
+
+            const int x0 = std::min(x * 2, width - 1);
+            const int x1 = std::min(x * 2 + 1, width - 1);
+
+            const std::array<const uchar*, 4> samples = {
+                row0 + x0 * 4, row0 + x1 * 4, row1 + x0 * 4, row1 + x1 * 4};
+
+            const std::array<int, 4> sample_owners = {
+                owner_row0[x0], owner_row0[x1], owner_row1[x0], owner_row1[x1]};
+
+            const int owner = majority_owner(sample_owners);
+
+            filter_pixel(samples, sample_owners, owner, channel_mask, dst_row + x * 4);
+            dst_owner_row[x] = owner;
+        }
+    }
+}
+
+int MipmapGenerator::level_count(int width, int height)
+{
+    return int(std::bit_width(unsigned(std::max({width, height, 1}))));
+}
+
+QList<QImage> MipmapGenerator::generate(const QImage&       image,
+                                        const QList<QRect>& regions,
+                                        const QList<int>&   region_channels)
+{
+    Q_ASSERT(image.depth() == 32);
+    Q_ASSERT(region_channels.isEmpty() || region_channels.size() == regions.size());
+
+    QList<QImage> levels;
+    levels.reserve(level_count(image.width(), image.height()));
+    levels.append(image);
+
+    int width  = image.width();
+    int height = image.height();
+
+    const bool is_per_channel =
+        std::any_of(region_channels.begin(), region_channels.end(), [](int c) { return c >= 0; });
+
+    // A single map for all channels, or one per channel.
+    QList<OwnerMap> maps;
+
+    if (is_per_channel)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            maps.append(OwnerMap{1 << c, QList<int>(qsizetype(width) * height, no_owner)});
+        }
+    }
+    else
+    {
+        maps.append(OwnerMap{all_channels, QList<int>(qsizetype(width) * height, no_owner)});
+    }
+
+    for (qsizetype i = 0; i < regions.size(); ++i)
+    {
+        const QRect rect    = regions[i].intersected(image.rect());
+        const int   channel = is_per_channel ? region_channels[i] : -1;
+
+        for (OwnerMap& map : maps)
+        {
+            if (channel >= 0 && map.channel_mask != 1 << channel)
+            {
+                continue;
+            }
+
+            for (int y = rect.top(); y <= rect.bottom(); ++y)
+            {
+                std::fill_n(map.owners.begin() + qsizetype(y) * width + rect.left(),
+                            rect.width(),
+                            int(i));
+            }
+        }
+    }
+
+    while (width > 1 || height > 1)
+    {
+        const int dst_width  = std::max(width / 2, 1);
+        const int dst_height = std::max(height / 2, 1);
+
+        QImage dst{dst_width, dst_height, levels.last().format()};
+
+        if (maps.size() > 1)
+        {
+            // Each map writes only its own channel.
+            dst.fill(0);
+        }
+
+        for (OwnerMap& map : maps)
+        {
+            QList<int> dst_owners(qsizetype(dst_width) * dst_height);
+
+            filter_level(levels.last(), map.owners, map.channel_mask, dst, dst_owners);
+
+            map.owners = std::move(dst_owners);
+        }
+
+        levels.append(std::move(dst));
+        width  = dst_width;
+        height = dst_height;
+    }
+
+    return levels;
+}
@@ -0,0 +1,36 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <QImage>
+#include <QList>
+#include <QRect>
+
+// Generates mip chains of pages without bleeding between glyphs.
+//
+// Each pixel of a smaller level is owned by a single region (glyph rectangle): the region that
+// covers most of the 2x2 pixels it is filtered from. Only the pixels of that region contribute,
+// the others count as transparent, so that neighboring glyphs never mix, no matter how tightly
+// they are packed.
+class MipmapGenerator final
+{
+  public:
+    MipmapGenerator() = delete;
+
+    // Returns all levels of a 32-bit image (of any channel order), from the image itself down to
+    // 1x1. Each level is half the size of the previous one (rounded down, at least 1).
+    // The image must have premultiplied or coverage-only channels, so that box filtering them
+    // channel by channel is correct.
+    //
+    // Regions may be restricted to a single channel (0 to 3, in memory order) by region_channels,
+    // which holds one entry per region (-1 for all channels). Ownership is then tracked per
+    // channel, so that regions of channel-packed pages, which overlap across channels, don't
+    // claim each other's pixels.
+    static QList<QImage> generate(const QImage&       image,
+                                  const QList<QRect>& regions,
+                                  const QList<int>&   region_channels = {});
+
+    static int level_count(int width, int height);
+};
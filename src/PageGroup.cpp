@@ -0,0 +1,120 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "PageGroup.hpp"
+
+#include <QStringList>
+#include <algorithm>
+
+PageGrouping page_grouping_from_string(const QString& value)
+{
+    if (value == "unicode_blocks")
+    {
+        return PageGrouping::UnicodeBlocks;
+    }
+
+    if (value == "custom")
+    {
+        return PageGrouping::Custom;
+    }
+
+    return PageGrouping::None;
+}
+
+QString page_grouping_to_string(PageGrouping value)
+{
+    switch (value)
+    {
+        case PageGrouping::None: return QStringLiteral("none");
+        case PageGrouping::UnicodeBlocks: return QStringLiteral("unicode_blocks");
+        case PageGrouping::Custom: return QStringLiteral("custom");
+    }
+
+    return QStringLiteral("none");
+}
+
+bool PageGroup::contains(QChar ch) const
+{
+    const uint32_t code = ch.unicode();
+
+    return std::ranges::any_of(ranges,
+                               [code](const Range& r) { return code >= r.first && code <= r.last; });
+}
+
+static std::optional<uint32_t> parse_code_point(QString str)
+{
+    str = str.trimmed();
+
+    if (str.startsWith(QStringLiteral("U+"), Qt::CaseInsensitive))
+    {
+        str = str.mid(2);
+    }
+
+    bool           ok{};
+    const uint32_t value = str.toUInt(&ok, 16);
+
+    if (!ok || value > 0xFFFF)
+    {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+std::optional<QList<PageGroup>> PageGroup::parse_list(const QString& str)
+{
+    QList<PageGroup> groups;
+
+    for (const QString& group_str : str.split(';', Qt::SkipEmptyParts))
+    {
+        if (group_str.trimmed().isEmpty())
+        {
+            continue;
+        }
+
+        PageGroup group;
+
+        QString ranges_str = group_str;
+
+        if (const qsizetype colon_index = group_str.indexOf(':'); colon_index >= 0)
+        {
+            group.name = group_str.left(colon_index).trimmed();
+            ranges_str = group_str.mid(colon_index + 1);
+        }
+
+        if (group.name.isEmpty())
+        {
+            group.name = QStringLiteral("Group %1").arg(groups.size());
+        }
+
+        for (const QString& range_str : ranges_str.split(',', Qt::SkipEmptyParts))
+        {
+            const QStringList parts = range_str.split('-');
+
+            if (parts.size() > 2)
+            {
+                return std::nullopt;
+            }
+
+            const std::optional<uint32_t> first = parse_code_point(parts.front());
+            const std::optional<uint32_t> last  = parse_code_point(parts.back());
+
+            if (!first || !last || *first > *last)
+            {
+                return std::nullopt;
+            }
+
+            group.ranges.append(Range{.first = *first, .last = *last});
+        }
+
+        if (group.ranges.isEmpty())
+        {
+            return std::nullopt;
+        }
+
+        groups.append(std::move(group));
+    }
+
+    return groups;
+}
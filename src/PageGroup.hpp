@@ -0,0 +1,46 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <optional>
+
+enum class PageGrouping
+{
+    None,
+    UnicodeBlocks,
+    Custom,
+};
+
+extern PageGrouping page_grouping_from_string(const QString& value);
+
+extern QString page_grouping_to_string(PageGrouping value);
+
+// A group of code point ranges whose glyphs are packed into their own, contiguous run
+// of pages. This allows a runtime to only load the pages of the groups it needs.
+class PageGroup
+{
+  public:
+    struct Range
+    {
+        uint32_t first{};
+        uint32_t last{};
+
+        bool operator==(const Range&) const = default;
+    };
+
+    QString      name;
+    QList<Range> ranges;
+    int          first_page_index{};
+    int          page_count{};
+
+    bool contains(QChar ch) const;
+
+    // Parses a list of groups in the form "Latin: 0020-007F, 00A0-00FF; Cyrillic: 0400-04FF".
+    // Groups are separated by semicolons and their order defines their priority.
+    // The name of a group is optional.
+    static std::optional<QList<PageGroup>> parse_list(const QString& str);
+};
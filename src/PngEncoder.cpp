@@ -0,0 +1,407 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "PngEncoder.hpp"
+
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QSet>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <vector>
+
+enum class PngColorType : uint8_t
+{
+    Grayscale = 0,
+    Indexed   = 3,
+    Rgba      = 6,
+};
+
+enum class PngFilter : uint8_t
+{
+    None    = 0,
+    Sub     = 1,
+    Up      = 2,
+    Average = 3,
+    Paeth   = 4,
+};
+
+static constexpr std::array<uint32_t, 256> s_crc_table = [] {
+    std::array<uint32_t, 256> table{};
+
+    for (uint32_t n = 0; n < 256; ++n)
+    {
+        uint32_t c = n;
+
+        for (int k = 0; k < 8; ++k)
+        {
+            c = (c & 1) != 0 ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+        }
+
+        table[n] = c;
+    }
+
+    return table;
+}();
+
+static uint32_t crc32(const char* data, qsizetype size)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (qsizetype i = 0; i < size; ++i)
+    {
+        crc = s_crc_table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+
+    return crc ^ 0xFFFFFFFFU;
+}
+
+static void append_u32_be(QByteArray& out, uint32_t value)
+{
+    out.append(static_cast<char>(value >> 24));
+    out.append(static_cast<char>(value >> 16));
+    out.append(static_cast<char>(value >> 8));
+    out.append(static_cast<char>(value));
+}
+
+static void append_chunk(QByteArray& out, const char* type, const QByteArray& data)
+{
+    append_u32_be(out, static_cast<uint32_t>(data.size()));
+
+    const qsizetype crc_start = out.size();
+    out.append(type, 4);
+    out.append(data);
+
+    append_u32_be(out, crc32(out.constData() + crc_start, out.size() - crc_start));
+}
+
+static inline uint8_t paeth_predictor(int a, int b, int c)
+{
+    const int p  = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+
+    if (pa <= pb && pa <= pc)
+    {
+        return static_cast<uint8_t>(a);
+    }
+
+    return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+static void filter_row(PngFilter      filter,
+                       const uint8_t* row,
+                       const uint8_t* prev,
+                       qsizetype      size,
+                       int            bpp,
+                       uint8_t*       dst)
+{
+    for (qsizetype i = 0; i < size; ++i)
+    {
+        const int a = i >= bpp ? row[i - bpp] : 0;
+        const int b = prev[i];
+        const int c = i >= bpp ? prev[i - bpp] : 0;
+
+        uint8_t predicted = 0;
+
+        switch (filter)
+        {
+            case PngFilter::None: predicted = 0; break;
+            case PngFilter::Sub: predicted = static_cast<uint8_t>(a); break;
+            case PngFilter::Up: predicted = static_cast<uint8_t>(b); break;
+            case PngFilter::Average: predicted = static_cast<uint8_t>((a + b) / 2); break;
+            case PngFilter::Paeth: predicted = paeth_predictor(a, b, c); break;
+        }
+
+        dst[i] = static_cast<uint8_t>(row[i] - predicted);
+    }
+}
+
+// Produces the uncompressed image data: each row prefixed by its filter type.
+template <typename GetRow>
+static QByteArray filter_rows(
+    qsizetype row_size, int height, int bpp, bool adaptive, GetRow&& get_row)
+{
+    QByteArray raw;
+    raw.resize((row_size + 1) * height);
+
+    const std::vector<uint8_t> zero_row(row_size, 0);
+
+    std::array<std::vector<uint8_t>, 5> candidates;
+    for (auto& candidate : candidates)
+    {
+        candidate.resize(row_size);
+    }
+
+    const uint8_t* prev = zero_row.data();
+
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t* row = get_row(y);
+        auto*          dst = reinterpret_cast<uint8_t*>(raw.data()) + y * (row_size + 1);
+
+        if (!adaptive)
+        {
+            dst[0] = static_cast<uint8_t>(PngFilter::None);
+            std::memcpy(dst + 1, row, row_size);
+            prev = row;
+            continue;
+        }
+
+        int      best_filter = 0;
+        uint64_t best_score  = std::numeric_limits<uint64_t>::max();
+
+        for (int filter = 0; filter < 5; ++filter)
+        {
+            uint8_t* candidate = candidates[filter].data();
+            filter_row(PngFilter(filter), row, prev, row_size, bpp, candidate);
+
+            // Treating the filtered bytes as signed values favors rows close to zero.
+            uint64_t score = 0;
+            for (qsizetype i = 0; i < row_size && score < best_score; ++i)
+            {
+                score += static_cast<uint64_t>(std::abs(static_cast<int8_t>(candidate[i])));
+            }
+
+            if (score < best_score)
+            {
+                best_score  = score;
+                best_filter = filter;
+            }
+        }
+
+        dst[0] = static_cast<uint8_t>(best_filter);
+        std::memcpy(dst + 1, candidates[best_filter].data(), row_size);
+
+        prev = row;
+    }
+
+    return raw;
+}
+
+struct Palette
+{
+    QList<uint32_t>          colors; // RGBA8888 pixels as stored in memory
+    QHash<uint32_t, uint8_t> indices;
+    int                      opaque_start{}; // Colors before this index have alpha < 255
+};
+
+static inline uint8_t alpha_of(uint32_t rgba)
+{
+    uint8_t bytes[4];
+    std::memcpy(bytes, &rgba, sizeof(bytes));
+    return bytes[3];
+}
+
+static std::optional<Palette> build_palette(const QImage& image)
+{
+    QList<uint32_t> colors;
+    QSet<uint32_t>  seen;
+
+    for (int y = 0; y < image.height(); ++y)
+    {
+        const auto* row = reinterpret_cast<const uint32_t*>(image.constScanLine(y));
+
+        uint32_t last{};
+        bool     has_last = false;
+
+        for (int x = 0; x < image.width(); ++x)
+        {
+            const uint32_t pixel = row[x];
+
+            if (has_last && pixel == last)
+            {
+                continue;
+            }
+
+            last     = pixel;
+            has_last = true;
+
+            if (!seen.contains(pixel))
+            {
+                if (colors.size() == 256)
+                {
+                    return std::nullopt;
+                }
+
+                seen.insert(pixel);
+                colors.append(pixel);
+            }
+        }
+    }
+
+    // Translucent colors come first, so that the tRNS chunk can omit the opaque ones.
+    std::stable_partition(colors.begin(), colors.end(), [](uint32_t color) {
+        return alpha_of(color) != 255;
+    });
+
+    Palette palette;
+    palette.colors       = std::move(colors);
+    palette.opaque_start = static_cast<int>(
+        std::count_if(palette.colors.cbegin(), palette.colors.cend(), [](uint32_t color) {
+            return alpha_of(color) != 255;
+        }));
+
+    for (qsizetype i = 0; i < palette.colors.size(); ++i)
+    {
+        palette.indices.insert(palette.colors[i], static_cast<uint8_t>(i));
+    }
+
+    return palette;
+}
+
+static int bit_depth_for_palette_size(qsizetype size)
+{
+    if (size <= 2)
+    {
+        return 1;
+    }
+
+    if (size <= 4)
+    {
+        return 2;
+    }
+
+    if (size <= 16)
+    {
+        return 4;
+    }
+
+    return 8;
+}
+
+QByteArray PngEncoder::encode(const QImage& image, const PngEncoderOptions& options)
+{
+    Q_ASSERT(image.format() == QImage::Format_Grayscale8 ||
+             image.format() == QImage::Format_RGBA8888);
+
+    const int  width    = image.width();
+    const int  height   = image.height();
+    const bool is_gray  = image.format() == QImage::Format_Grayscale8;
+    const int  level    = std::clamp(options.compression_level, 0, 9);
+    const bool adaptive = level > 0; // Filtering doesn't pay off for stored (level 0) data
+
+    std::optional<Palette> palette;
+
+    if (!is_gray && options.allow_palette)
+    {
+        palette = build_palette(image);
+    }
+
+    PngColorType color_type = PngColorType::Rgba;
+    int          bit_depth  = 8;
+    QByteArray   raw;
+
+    if (palette)
+    {
+        color_type = PngColorType::Indexed;
+        bit_depth  = bit_depth_for_palette_size(palette->colors.size());
+
+        const int       pixels_per_byte = 8 / bit_depth;
+        const qsizetype row_size        = (qsizetype(width) * bit_depth + 7) / 8;
+
+        std::vector<uint8_t> packed(row_size * height, 0);
+
+        for (int y = 0; y < height; ++y)
+        {
+            const auto* row = reinterpret_cast<const uint32_t*>(image.constScanLine(y));
+            uint8_t*    dst = packed.data() + y * row_size;
+
+            for (int x = 0; x < width; ++x)
+            {
+                const uint8_t index = palette->indices.value(row[x]);
+                const int     shift = 8 - bit_depth * (x % pixels_per_byte + 1);
+                dst[x / pixels_per_byte] |= static_cast<uint8_t>(index << shift);
+            }
+        }
+
+        // Indexed images compress best without filtering.
+        raw = filter_rows(row_size, height, 1, false, [&](int y) {
+            return packed.data() + y * row_size;
+        });
+    }
+    else
+    {
+        color_type = is_gray ? PngColorType::Grayscale : PngColorType::Rgba;
+
+        const int bpp = is_gray ? 1 : 4;
+
+        raw = filter_rows(qsizetype(width) * bpp, height, bpp, adaptive, [&](int y) {
+            return image.constScanLine(y);
+        });
+    }
+
+    QByteArray png;
+    png.append("\x89PNG\r\n\x1A\n", 8);
+
+    // IHDR
+    {
+        QByteArray ihdr;
+        append_u32_be(ihdr, static_cast<uint32_t>(width));
+        append_u32_be(ihdr, static_cast<uint32_t>(height));
+        ihdr.append(static_cast<char>(bit_depth));
+        ihdr.append(static_cast<char>(color_type));
+        ihdr.append('\0'); // Compression method: deflate
+        ihdr.append('\0'); // Filter method: adaptive
+        ihdr.append('\0'); // Interlace method: none
+        append_chunk(png, "IHDR", ihdr);
+    }
+
+    if (palette)
+    {
+        QByteArray plte;
+        QByteArray trns;
+
+        for (qsizetype i = 0; i < palette->colors.size(); ++i)
+        {
+            uint8_t rgba[4];
+            std::memcpy(rgba, &palette->colors[i], sizeof(rgba));
+
+            plte.append(reinterpret_cast<const char*>(rgba), 3);
+
+            if (i < palette->opaque_start)
+            {
+                trns.append(static_cast<char>(rgba[3]));
+            }
+        }
+
+        append_chunk(png, "PLTE", plte);
+
+        if (!trns.isEmpty())
+        {
+            append_chunk(png, "tRNS", trns);
+        }
+    }
+
+    // qCompress produces a zlib stream, prefixed by the uncompressed size (4 bytes, big-endian).
+    QByteArray compressed = qCompress(raw, level);
+    compressed.remove(0, 4);
+
+    append_chunk(png, "IDAT", compressed);
+    append_chunk(png, "IEND", QByteArray{});
+
+    return png;
+}
+
+bool PngEncoder::save(const QImage&            image,
+                      const QString&           filename,
+                      const PngEncoderOptions& options)
+{
+    QFile file{filename};
+
+    if (!file.open(QFile::WriteOnly))
+    {
+        return false;
+    }
+
+    const QByteArray data = encode(image, options);
+
+    return file.write(data) == data.size();
+}
@@ -0,0 +1,33 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+class QImage;
+
+struct PngEncoderOptions
+{
+    int  compression_level{6}; // zlib level, from 0 (fastest) to 9 (smallest)
+    bool allow_palette{true};  // Write an indexed image if it has at most 256 distinct colors
+};
+
+// Encodes pages as PNG with control over the compression level.
+// Row filters are chosen per row by the minimum sum of absolute differences heuristic, and
+// RGBA images with few distinct colors are written as indexed images (PLTE + tRNS) with the
+// smallest possible bit depth.
+class PngEncoder final
+{
+  public:
+    PngEncoder() = delete;
+
+    // Encodes a QImage::Format_Grayscale8 or QImage::Format_RGBA8888 image.
+    static QByteArray encode(const QImage& image, const PngEncoderOptions& options);
+
+    static bool save(const QImage&            image,
+                     const QString&           filename,
+                     const PngEncoderOptions& options);
+};
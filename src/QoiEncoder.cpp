@@ -0,0 +1,205 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "QoiEncoder.hpp"
+
+#include <QFile>
+#include <QImage>
+#include <array>
+
+namespace
+{
+constexpr uint8_t qoi_op_index = 0x00;
+constexpr uint8_t qoi_op_diff  = 0x40;
+constexpr uint8_t qoi_op_luma  = 0x80;
+constexpr uint8_t qoi_op_run   = 0xC0;
+constexpr uint8_t qoi_op_rgb   = 0xFE;
+constexpr uint8_t qoi_op_rgba  = 0xFF;
+
+constexpr int qoi_max_run = 62;
+
+struct Rgba
+{
+    uint8_t r{};
+    uint8_t g{};
+    uint8_t b{};
+    uint8_t a{};
+
+    bool operator==(const Rgba&) const = default;
+
+    int hash() const
+    {
+        return (r * 3 + g * 5 + b * 7 + a * 11) % 64;
+    }
+};
+
+class QoiWriter
+{
+  public:
+    explicit QoiWriter(QByteArray& out)
+        : m_out(out)
+    {
+    }
+
+    void put(Rgba pixel)
+    {
+        if (pixel == m_previous)
+        {
+            ++m_run;
+
+            if (m_run == qoi_max_run)
+            {
+                flush_run();
+            }
+
+            return;
+        }
+
+        flush_run();
+
+        const int hash = pixel.hash();
+
+        if (m_index[hash] == pixel)
+        {
+            put_byte(qoi_op_index | uint8_t(hash));
+        }
+        else
+        {
+            m_index[hash] = pixel;
+
+            if (pixel.a == m_previous.a)
+            {
+                const auto dr = static_cast<int8_t>(pixel.r - m_previous.r);
+                const auto dg = static_cast<int8_t>(pixel.g - m_previous.g);
+                const auto db = static_cast<int8_t>(pixel.b - m_previous.b);
+
+                const int dr_dg = dr - dg;
+                const int db_dg = db - dg;
+
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+                {
+                    put_byte(qoi_op_diff | uint8_t((dr + 2) << 4) | uint8_t((dg + 2) << 2) |
+                             uint8_t(db + 2));
+                }
+                else if (dr_dg >= -8 && dr_dg <= 7 && dg >= -32 && dg <= 31 && db_dg >= -8 &&
+                         db_dg <= 7)
+                {
+                    put_byte(qoi_op_luma | uint8_t(dg + 32));
+                    put_byte(uint8_t((dr_dg + 8) << 4) | uint8_t(db_dg + 8));
+                }
+                else
+                {
+                    put_byte(qoi_op_rgb);
+                    put_byte(pixel.r);
+                    put_byte(pixel.g);
+                    put_byte(pixel.b);
+                }
+            }
+            else
+            {
+                put_byte(qoi_op_rgba);
+                put_byte(pixel.r);
+                put_byte(pixel.g);
+                put_byte(pixel.b);
+                put_byte(pixel.a);
+            }
+        }
+
+        m_previous = pixel;
+    }
+
+    void flush_run()
+    {
+        if (m_run > 0)
+        {
+            put_byte(qoi_op_run | uint8_t(m_run - 1));
+            m_run = 0;
+        }
+    }
+
+  private:
+    void put_byte(uint8_t value)
+    {
+        m_out.append(static_cast<char>(value));
+    }
+
+    QByteArray&          m_out;
+    std::array<Rgba, 64> m_index{};
+    Rgba                 m_previous{0, 0, 0, 255};
+    int                  m_run{};
+};
+
+void append_u32_be(QByteArray& out, uint32_t value)
+{
+    out.append(static_cast<char>(value >> 24));
+    out.append(static_cast<char>(value >> 16));
+    out.append(static_cast<char>(value >> 8));
+    out.append(static_cast<char>(value));
+}
+} // namespace
+
+QByteArray QoiEncoder::encode(const QImage& image)
+{
+    Q_ASSERT(image.format() == QImage::Format_Grayscale8 ||
+             image.format() == QImage::Format_RGBA8888);
+
+    const bool is_gray = image.format() == QImage::Format_Grayscale8;
+    const int  width   = image.width();
+    const int  height  = image.height();
+
+    QByteArray out;
+    out.reserve(14 + qsizetype(width) * height + 8);
+
+    // Header
+    out.append("qoif", 4);
+    append_u32_be(out, uint32_t(width));
+    append_u32_be(out, uint32_t(height));
+    out.append(static_cast<char>(is_gray ? 3 : 4)); // Channels
+    out.append('\0');                               // Color space: sRGB with linear alpha
+
+    QoiWriter writer{out};
+
+    for (int y = 0; y < height; ++y)
+    {
+        const uchar* row = image.constScanLine(y);
+
+        if (is_gray)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                writer.put(Rgba{row[x], row[x], row[x], 255});
+            }
+        }
+        else
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const uchar* p = row + x * 4;
+                writer.put(Rgba{p[0], p[1], p[2], p[3]});
+            }
+        }
+    }
+
+    writer.flush_run();
+
+    // End marker
+    out.append(QByteArray(7, '\0'));
+    out.append('\x01');
+
+    return out;
+}
+
+bool QoiEncoder::save(const QImage& image, const QString& filename)
+{
+    QFile file{filename};
+
+    if (!file.open(QFile::WriteOnly))
+    {
+        return false;
+    }
+
+    const QByteArray data = encode(image);
+
+    return file.write(data) == data.size();
+}
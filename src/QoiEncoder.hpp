@@ -0,0 +1,25 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+class QImage;
+
+// Encodes pages in the "Quite OK Image" format (https://qoiformat.org), which decodes
+// considerably faster than PNG.
+class QoiEncoder final
+{
+  public:
+    QoiEncoder() = delete;
+
+    // Encodes a QImage::Format_Grayscale8 or QImage::Format_RGBA8888 image.
+    // QOI has no single-channel mode, so grayscale images are written as 3-channel images with
+    // equal color channels, which QOI's difference operations encode compactly.
+    static QByteArray encode(const QImage& image);
+
+    static bool save(const QImage& image, const QString& filename);
+};
@@ -5,23 +5,315 @@
 #include "QtImageUtil.hpp"
 
 #include <QImage>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define BMFGEN_HAS_SSE2
+#endif
+
+// Returns whether a row of 32-bit (A)RGB pixels only consists of shades of gray.
+// For each pixel, p ^ (p >> 8) holds B ^ G in its lowest and G ^ R in its second byte,
+// which are both zero exactly if R == G == B.
+static bool is_row_monochromatic(const uint32_t* row, qsizetype count)
+{
+    qsizetype i = 0;
+
+#ifdef BMFGEN_HAS_SSE2
+    __m128i diff = _mm_setzero_si128();
+
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto*   src = reinterpret_cast<const __m128i*>(row + i);
+        const __m128i p0  = _mm_loadu_si128(src);
+        const __m128i p1  = _mm_loadu_si128(src + 1);
+        const __m128i p2  = _mm_loadu_si128(src + 2);
+        const __m128i p3  = _mm_loadu_si128(src + 3);
+
+        diff = _mm_or_si128(diff, _mm_xor_si128(p0, _mm_srli_epi32(p0, 8)));
+        diff = _mm_or_si128(diff, _mm_xor_si128(p1, _mm_srli_epi32(p1, 8)));
+        diff = _mm_or_si128(diff, _mm_xor_si128(p2, _mm_srli_epi32(p2, 8)));
+        diff = _mm_or_si128(diff, _mm_xor_si128(p3, _mm_srli_epi32(p3, 8)));
+    }
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        diff            = _mm_or_si128(diff, _mm_xor_si128(p, _mm_srli_epi32(p, 8)));
+    }
+
+    diff = _mm_and_si128(diff, _mm_set1_epi32(0xFFFF));
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(diff, _mm_setzero_si128())) != 0xFFFF)
+    {
+        return false;
+    }
+#endif
+
+    uint32_t scalar_diff = 0;
+
+    for (; i < count; ++i)
+    {
+        scalar_diff |= row[i] ^ (row[i] >> 8);
+    }
+
+    return (scalar_diff & 0xFFFF) == 0;
+}
 
 bool QtImageUtil::is_monochromatic(const QImage& image)
 {
+    switch (image.format())
+    {
+        case QImage::Format_Grayscale8:
+        case QImage::Format_Grayscale16:
+        case QImage::Format_Alpha8: return true;
+
+        // Premultiplying scales R, G and B by the same factor, so premultiplied pixels are gray
+        // exactly if their unpremultiplied colors are.
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32:
+        case QImage::Format_ARGB32_Premultiplied: break;
+
+        default: return is_monochromatic(image.convertToFormat(QImage::Format_ARGB32));
+    }
+
     const int width  = image.width();
     const int height = image.height();
 
+    // Rows are checked one at a time, so that colored pages are rejected early.
     for (int y = 0; y < height; ++y)
     {
-        for (int x = 0; x < width; ++x)
+        if (!is_row_monochromatic(reinterpret_cast<const uint32_t*>(image.constScanLine(y)),
+                                  width))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Reciprocals of all alpha values in 16.16 fixed point, used to unpremultiply without divisions.
+static constexpr std::array<uint32_t, 256> s_inverse_alpha_table = [] {
+    std::array<uint32_t, 256> table{};
+
+    for (uint32_t a = 1; a < 256; ++a)
+    {
+        table[a] = (255U << 16) / a;
+    }
+
+    return table;
+}();
+
+static constexpr bool is_premultiplied(PixelLayout layout)
+{
+    return layout == PixelLayout::Rgba8888Premultiplied ||
+           layout == PixelLayout::Rgba8888LinearPremultiplied;
+}
+
+// Lookup tables between sRGB-encoded values and linear values in 0.16 fixed point.
+// The inverse table is indexed by linear values in 0.12 fixed point.
+struct SrgbTables
+{
+    std::array<uint16_t, 256>  to_linear{};
+    std::array<uint8_t, 4096> from_linear{};
+};
+
+static const SrgbTables& srgb_tables()
+{
+    static const SrgbTables tables = [] {
+        SrgbTables t;
+
+        for (int i = 0; i < 256; ++i)
+        {
+            const double c      = i / 255.0;
+            const double linear = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+            t.to_linear[i]      = uint16_t(std::lround(linear * 65535.0));
+        }
+
+        for (int i = 0; i < 4096; ++i)
+        {
+            const double linear = i / 4095.0;
+            const double c      = linear <= 0.0031308 ? linear * 12.92
+                                                      : 1.055 * std::pow(linear, 1 / 2.4) - 0.055;
+            t.from_linear[i]    = uint8_t(std::lround(c * 255.0));
+        }
+
+        return t;
+    }();
+
+    return tables;
+}
+
+// Turns a channel that is premultiplied in sRGB space into one that is premultiplied in linear
+// space (and sRGB-encoded), for alpha values other than 0 and 255.
+static inline uint32_t premultiply_linear(uint32_t value, uint32_t a)
+{
+    const SrgbTables& tables = srgb_tables();
+
+    const uint32_t straight = std::min((value * s_inverse_alpha_table[a] + 0x8000) >> 16, 255U);
+    const uint32_t linear   = (tables.to_linear[straight] * a + 127) / 255;
+
+    return tables.from_linear[(linear * 4095 + 32767) / 65535];
+}
+
+static inline void convert_pixel(uint32_t argb, uchar* dst, PixelLayout layout)
+{
+    const uint32_t a = argb >> 24;
+    uint32_t       r = (argb >> 16) & 0xFF;
+    uint32_t       g = (argb >> 8) & 0xFF;
+    uint32_t       b = argb & 0xFF;
+
+    if (a != 0 && a != 255)
+    {
+        if (!is_premultiplied(layout))
+        {
+            const uint32_t inv = s_inverse_alpha_table[a];
+
+            r = (r * inv + 0x8000) >> 16;
+            g = (g * inv + 0x8000) >> 16;
+            b = (b * inv + 0x8000) >> 16;
+        }
+        else if (layout == PixelLayout::Rgba8888LinearPremultiplied)
+        {
+            r = premultiply_linear(r, a);
+            g = premultiply_linear(g, a);
+            b = premultiply_linear(b, a);
+        }
+    }
+
+    if (layout == PixelLayout::Bgra8888)
+    {
+        std::swap(r, b);
+    }
+
+    dst[0] = uchar(r);
+    dst[1] = uchar(g);
+    dst[2] = uchar(b);
+    dst[3] = uchar(a);
+}
+
+#ifdef BMFGEN_HAS_SSE2
+// Swaps the R and B channels of four ARGB32 pixels, yielding RGBA8888 byte order.
+static inline __m128i swap_red_blue(__m128i pixels)
+{
+    const __m128i ag_mask = _mm_set1_epi32(int(0xFF00FF00));
+    const __m128i b_mask  = _mm_set1_epi32(0xFF);
+
+    const __m128i ag = _mm_and_si128(pixels, ag_mask);
+    const __m128i r  = _mm_and_si128(_mm_srli_epi32(pixels, 16), b_mask);
+    const __m128i b  = _mm_slli_epi32(_mm_and_si128(pixels, b_mask), 16);
+
+    return _mm_or_si128(ag, _mm_or_si128(r, b));
+}
+#endif
+
+void QtImageUtil::convert_row(const uint32_t* src, uchar* dst, qsizetype count, PixelLayout layout)
+{
+    qsizetype i = 0;
+
+#ifdef BMFGEN_HAS_SSE2
+    // Most pixels of a font page are either fully transparent or fully opaque. Such pixels
+    // are the same in every layout, so blocks of them are only swizzled.
+    // Pages are premultiplied in sRGB space already, so that layout is swizzled entirely.
+    const __m128i alpha_mask = _mm_set1_epi32(int(0xFF000000));
+    const __m128i zero       = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i alpha  = _mm_and_si128(pixels, alpha_mask);
+
+        const bool is_opaque_or_transparent =
+            _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi32(alpha, alpha_mask),
+                                           _mm_cmpeq_epi32(alpha, zero))) == 0xFFFF;
+
+        if (layout != PixelLayout::Rgba8888Premultiplied && !is_opaque_or_transparent)
         {
-            if (const QColor color = image.pixelColor(x, y);
-                color.red() != color.green() || color.green() != color.blue())
+            for (qsizetype j = i; j < i + 4; ++j)
             {
-                return false;
+                convert_pixel(src[j], dst + j * 4, layout);
             }
+
+            continue;
         }
+
+        const __m128i result = layout == PixelLayout::Bgra8888 ? pixels : swap_red_blue(pixels);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), result);
     }
+#endif
 
-    return true;
+    for (; i < count; ++i)
+    {
+        convert_pixel(src[i], dst + i * 4, layout);
+    }
+}
+
+QImage QtImageUtil::convert(const QImage& image, PixelLayout layout, bool flip_vertically)
+{
+    Q_ASSERT(image.format() == QImage::Format_ARGB32_Premultiplied);
+
+    const QImage::Format format = [layout] {
+        switch (layout)
+        {
+            case PixelLayout::Rgba8888: return QImage::Format_RGBA8888;
+            case PixelLayout::Bgra8888: return QImage::Format_ARGB32;
+            case PixelLayout::Rgba8888Premultiplied:
+            case PixelLayout::Rgba8888LinearPremultiplied:
+                return QImage::Format_RGBA8888_Premultiplied;
+        }
+
+        return QImage::Format_RGBA8888;
+    }();
+
+    QImage result{image.size(), format};
+
+    const int width  = image.width();
+    const int height = image.height();
+
+    for (int y = 0; y < height; ++y)
+    {
+        const int src_y = flip_vertically ? height - 1 - y : y;
+
+        convert_row(reinterpret_cast<const uint32_t*>(image.constScanLine(src_y)),
+                    result.scanLine(y),
+                    width,
+                    layout);
+    }
+
+    return result;
+}
+
+qsizetype QtImageUtil::packed_row_pitch(int width, int bits_per_pixel)
+{
+    return (qsizetype(width) * bits_per_pixel + 7) / 8;
+}
+
+void QtImageUtil::pack_gray_row(const uchar* src, uchar* dst, int width, int bits_per_pixel)
+{
+    switch (bits_per_pixel)
+    {
+        case 8: std::memcpy(dst, src, size_t(width)); break;
+        case 4:
+            for (int x = 0; x < width; ++x)
+            {
+                const int value = (src[x] * 15 + 127) / 255;
+                dst[x / 2] |= uchar(x % 2 == 0 ? value << 4 : value);
+            }
+            break;
+        case 1:
+            for (int x = 0; x < width; ++x)
+            {
+                if (src[x] >= 128)
+                {
+                    dst[x / 8] |= uchar(0x80 >> (x % 8));
+                }
+            }
+            break;
+        default: Q_UNREACHABLE();
+    }
 }
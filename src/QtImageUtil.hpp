@@ -4,12 +4,45 @@
 
 #pragma once
 
+#include <QtGlobal>
+#include <cstdint>
+
 class QImage;
 
+// The byte layouts that pages can be converted to for export.
+enum class PixelLayout
+{
+    Rgba8888,              // Straight alpha, byte order R, G, B, A
+    Bgra8888,              // Straight alpha, byte order B, G, R, A
+    Rgba8888Premultiplied, // Premultiplied alpha, byte order R, G, B, A
+
+    // Premultiplied in linear space and then sRGB-encoded, byte order R, G, B, A.
+    // Sampling such pixels from an sRGB texture yields linear premultiplied colors.
+    Rgba8888LinearPremultiplied,
+};
+
 class QtImageUtil final
 {
   public:
     QtImageUtil() = delete;
 
+    // Returns whether all pixels of an image are shades of gray (R == G == B).
     static bool is_monochromatic(const QImage& image);
+
+    // Converts a row of premultiplied ARGB32 pixels to the specified layout.
+    static void convert_row(const uint32_t* src, uchar* dst, qsizetype count, PixelLayout layout);
+
+    // Converts a premultiplied ARGB32 image to an image of the specified layout.
+    // The Bgra8888 layout is returned as QImage::Format_ARGB32 (little-endian only).
+    // If flip_vertically is set, rows are converted in reverse order, which flips the image
+    // without a copy of its own.
+    static QImage convert(const QImage& image, PixelLayout layout, bool flip_vertically = false);
+
+    // Returns the size of a row of packed pixels in bytes. Rows are padded to whole bytes.
+    static qsizetype packed_row_pitch(int width, int bits_per_pixel);
+
+    // Packs a row of 8-bit gray values into 8, 4 or 1 bits per pixel, most significant bits first.
+    // 4-bit values are rounded, 1-bit values are thresholded at 50%.
+    // The destination row must be zero-initialized.
+    static void pack_gray_row(const uchar* src, uchar* dst, int width, int bits_per_pixel);
 };
@@ -0,0 +1,279 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "TextureContainer.hpp"
+
+#include <QtEndian>
+
+static void append_u8(QByteArray& out, uint8_t value)
+{
+    out.append(static_cast<char>(value));
+}
+
+static void append_u32(QByteArray& out, uint32_t value)
+{
+    value = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void append_u64(QByteArray& out, uint64_t value)
+{
+    value = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void pad_to(QByteArray& out, qsizetype alignment)
+{
+    while (out.size() % alignment != 0)
+    {
+        out.append('\0');
+    }
+}
+
+/*
+ * DDS
+ */
+
+static uint32_t dxgi_format(const CompressedTexture& texture)
+{
+    constexpr uint32_t dxgi_format_bc4_unorm      = 80;
+    constexpr uint32_t dxgi_format_bc7_unorm      = 98;
+    constexpr uint32_t dxgi_format_bc7_unorm_srgb = 99;
+
+    if (texture.format == BlockFormat::Bc4)
+    {
+        return dxgi_format_bc4_unorm;
+    }
+
+    return texture.alpha_mode == TextureAlphaMode::LinearPremultiplied ? dxgi_format_bc7_unorm_srgb
+                                                                        : dxgi_format_bc7_unorm;
+}
+
+static uint32_t dds_alpha_mode(const CompressedTexture& texture)
+{
+    constexpr uint32_t dds_alpha_mode_unknown       = 0;
+    constexpr uint32_t dds_alpha_mode_straight      = 1;
+    constexpr uint32_t dds_alpha_mode_premultiplied = 2;
+
+    if (texture.format == BlockFormat::Bc4)
+    {
+        return dds_alpha_mode_unknown;
+    }
+
+    return texture.alpha_mode == TextureAlphaMode::Straight ? dds_alpha_mode_straight
+                                                             : dds_alpha_mode_premultiplied;
+}
+
+QByteArray TextureContainer::encode_dds(const CompressedTexture& texture)
+{
+    constexpr uint32_t ddsd_caps        = 0x1;
+    constexpr uint32_t ddsd_height      = 0x2;
+    constexpr uint32_t ddsd_width       = 0x4;
+    constexpr uint32_t ddsd_pixelformat = 0x1000;
+    constexpr uint32_t ddsd_mipmapcount = 0x20000;
+    constexpr uint32_t ddsd_linearsize  = 0x80000;
+    constexpr uint32_t ddpf_fourcc      = 0x4;
+    constexpr uint32_t ddscaps_complex  = 0x8;
+    constexpr uint32_t ddscaps_texture  = 0x1000;
+    constexpr uint32_t ddscaps_mipmap   = 0x400000;
+
+    const bool has_mips = texture.levels.size() > 1;
+
+    QByteArray out;
+    out.append("DDS ", 4);
+
+    // DDS_HEADER
+    append_u32(out, 124);
+    append_u32(out,
+               ddsd_caps | ddsd_height | ddsd_width | ddsd_pixelformat | ddsd_linearsize |
+                   (has_mips ? ddsd_mipmapcount : 0));
+    append_u32(out, uint32_t(texture.height));
+    append_u32(out, uint32_t(texture.width));
+    append_u32(out, uint32_t(texture.levels.first().size())); // pitchOrLinearSize
+    append_u32(out, 0);                                       // depth
+    append_u32(out, uint32_t(texture.levels.size()));         // mipMapCount
+
+    for (int i = 0; i < 11; ++i) // reserved1
+    {
+        append_u32(out, 0);
+    }
+
+    // DDS_PIXELFORMAT
+    append_u32(out, 32);
+    append_u32(out, ddpf_fourcc);
+    out.append("DX10", 4);
+
+    for (int i = 0; i < 5; ++i) // RGB bit count and masks
+    {
+        append_u32(out, 0);
+    }
+
+    append_u32(out,
+               ddscaps_texture | (has_mips ? ddscaps_complex | ddscaps_mipmap : 0)); // caps
+
+    for (int i = 0; i < 4; ++i) // caps2, caps3, caps4, reserved2
+    {
+        append_u32(out, 0);
+    }
+
+    // DDS_HEADER_DXT10
+    constexpr uint32_t d3d10_resource_dimension_texture2d = 3;
+
+    append_u32(out, dxgi_format(texture));
+    append_u32(out, d3d10_resource_dimension_texture2d);
+    append_u32(out, 0); // miscFlag
+    append_u32(out, 1); // arraySize
+    append_u32(out, dds_alpha_mode(texture));
+
+    for (const QByteArray& level : texture.levels)
+    {
+        out.append(level);
+    }
+
+    return out;
+}
+
+/*
+ * KTX2
+ */
+
+static uint32_t vk_format(const CompressedTexture& texture)
+{
+    constexpr uint32_t vk_format_bc4_unorm_block = 139;
+    constexpr uint32_t vk_format_bc7_unorm_block = 145;
+    constexpr uint32_t vk_format_bc7_srgb_block  = 146;
+
+    if (texture.format == BlockFormat::Bc4)
+    {
+        return vk_format_bc4_unorm_block;
+    }
+
+    return texture.alpha_mode == TextureAlphaMode::LinearPremultiplied ? vk_format_bc7_srgb_block
+                                                                        : vk_format_bc7_unorm_block;
+}
+
+// Builds the basic data format descriptor of a block-compressed texture.
+static QByteArray build_dfd(const CompressedTexture& texture)
+{
+    constexpr uint8_t khr_df_model_bc4                = 131;
+    constexpr uint8_t khr_df_model_bc7                = 134;
+    constexpr uint8_t khr_df_primaries_bt709          = 1;
+    constexpr uint8_t khr_df_transfer_linear          = 1;
+    constexpr uint8_t khr_df_transfer_srgb            = 2;
+    constexpr uint8_t khr_df_flag_alpha_straight      = 0;
+    constexpr uint8_t khr_df_flag_alpha_premultiplied = 1;
+
+    const bool is_bc4 = texture.format == BlockFormat::Bc4;
+
+    const bool is_srgb = !is_bc4 && texture.alpha_mode == TextureAlphaMode::LinearPremultiplied;
+    const bool is_premultiplied = !is_bc4 && texture.alpha_mode != TextureAlphaMode::Straight;
+
+    const uint32_t block_bytes = uint32_t(BlockCompressor::bytes_per_block(texture.format));
+
+    QByteArray block;
+    append_u32(block, 0);               // vendorId | descriptorType
+    append_u32(block, 2 | (40U << 16)); // versionNumber | descriptorBlockSize
+    append_u8(block, is_bc4 ? khr_df_model_bc4 : khr_df_model_bc7);
+    append_u8(block, khr_df_primaries_bt709);
+    append_u8(block, is_srgb ? khr_df_transfer_srgb : khr_df_transfer_linear);
+    append_u8(block,
+              is_premultiplied ? khr_df_flag_alpha_premultiplied : khr_df_flag_alpha_straight);
+    append_u32(block, 3 | (3U << 8)); // texelBlockDimension0..3 (4x4x1x1, minus one)
+    append_u32(block, block_bytes);   // bytesPlane0..3
+    append_u32(block, 0);             // bytesPlane4..7
+
+    // A single sample that covers the whole block.
+    append_u32(block, (block_bytes * 8 - 1) << 16); // bitOffset | bitLength | channelType
+    append_u32(block, 0);                           // samplePosition0..3
+    append_u32(block, 0);                           // sampleLower
+    append_u32(block, 0xFFFFFFFF);                  // sampleUpper
+
+    QByteArray dfd;
+    append_u32(dfd, uint32_t(4 + block.size())); // dfdTotalSize
+    dfd.append(block);
+
+    return dfd;
+}
+
+static QByteArray build_kvd()
+{
+    const QByteArray entry = QByteArrayLiteral("KTXwriter\0BMFGen\0");
+
+    QByteArray kvd;
+    append_u32(kvd, uint32_t(entry.size()));
+    kvd.append(entry);
+    pad_to(kvd, 4);
+
+    return kvd;
+}
+
+QByteArray TextureContainer::encode_ktx2(const CompressedTexture& texture)
+{
+    static constexpr char identifier[12] = {
+        '\xAB', 'K', 'T', 'X', ' ', '2', '0', '\xBB', '\r', '\n', '\x1A', '\n'};
+
+    const QByteArray dfd = build_dfd(texture);
+    const QByteArray kvd = build_kvd();
+
+    const qsizetype level_count        = texture.levels.size();
+    const qsizetype level_index_offset = 12 + 36 + 32;
+    const qsizetype dfd_offset         = level_index_offset + level_count * 24;
+    const qsizetype kvd_offset         = dfd_offset + dfd.size();
+
+    // Level data is aligned to the least common multiple of the block size and 4, and stored
+    // from the smallest to the largest level.
+    const int       alignment = BlockCompressor::bytes_per_block(texture.format);
+    QList<uint64_t> level_offsets(level_count);
+    {
+        qsizetype offset = kvd_offset + kvd.size();
+
+        for (qsizetype i = level_count - 1; i >= 0; --i)
+        {
+            offset           = (offset + alignment - 1) / alignment * alignment;
+            level_offsets[i] = uint64_t(offset);
+            offset += texture.levels[i].size();
+        }
+    }
+
+    QByteArray out;
+    out.append(identifier, sizeof(identifier));
+
+    // Header
+    append_u32(out, vk_format(texture));
+    append_u32(out, 1); // typeSize
+    append_u32(out, uint32_t(texture.width));
+    append_u32(out, uint32_t(texture.height));
+    append_u32(out, 0); // pixelDepth
+    append_u32(out, 0); // layerCount
+    append_u32(out, 1); // faceCount
+    append_u32(out, uint32_t(level_count));
+    append_u32(out, 0); // supercompressionScheme
+
+    // Index
+    append_u32(out, uint32_t(dfd_offset));
+    append_u32(out, uint32_t(dfd.size()));
+    append_u32(out, uint32_t(kvd_offset));
+    append_u32(out, uint32_t(kvd.size()));
+    append_u64(out, 0); // sgdByteOffset
+    append_u64(out, 0); // sgdByteLength
+
+    // Level index
+    for (qsizetype i = 0; i < level_count; ++i)
+    {
+        append_u64(out, level_offsets[i]);
+        append_u64(out, uint64_t(texture.levels[i].size()));
+        append_u64(out, uint64_t(texture.levels[i].size()));
+    }
+
+    out.append(dfd);
+    out.append(kvd);
+
+    for (qsizetype i = level_count - 1; i >= 0; --i)
+    {
+        out.append(QByteArray(qsizetype(level_offsets[i]) - out.size(), '\0'));
+        out.append(texture.levels[i]);
+    }
+
+    return out;
+}
@@ -0,0 +1,42 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include "BlockCompressor.hpp"
+#include <QList>
+
+// How the alpha of a texture relates to its colors. Only relevant for BC7.
+enum class TextureAlphaMode
+{
+    Straight,
+    Premultiplied,
+
+    // Premultiplied in linear space and then sRGB-encoded. Written with sRGB formats, so that
+    // samplers decode the colors before they are blended.
+    LinearPremultiplied,
+};
+
+// A block-compressed texture, ready to be uploaded to the GPU.
+struct CompressedTexture
+{
+    BlockFormat       format{};
+    TextureAlphaMode  alpha_mode{};
+    int               width{};
+    int               height{};
+    QList<QByteArray> levels; // Mip levels, starting with the full-size image
+};
+
+// Writes compressed textures to container files.
+class TextureContainer final
+{
+  public:
+    TextureContainer() = delete;
+
+    // DirectDraw Surface with a DX10 header extension.
+    static QByteArray encode_dds(const CompressedTexture& texture);
+
+    // Khronos KTX 2.0, without supercompression.
+    static QByteArray encode_ktx2(const CompressedTexture& texture);
+};
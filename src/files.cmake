@@ -1,14 +1,21 @@
 set(SOURCE_FILES
+  BinaryFontFormat.hpp
+  BlockCompressor.cpp
+  BlockCompressor.hpp
+  BufferedWriter.cpp
+  BufferedWriter.hpp
   CharacterSet.cpp
   CharacterSet.hpp
   Constants.cpp
   Constants.hpp
+  ExportManifest.cpp
+  ExportManifest.hpp
   FontModel.cpp
   FontModel.hpp
   FontGenContext.cpp
   FontGenContext.hpp
-  FontGenWorkerThread.cpp
-  FontGenWorkerThread.hpp
+  FontExportWorkerThread.cpp
+  FontExportWorkerThread.hpp
   FontPage.cpp
   FontPage.hpp
   GeneratedFont.cpp
@@ -16,13 +23,25 @@ set(SOURCE_FILES
   Glyph.hpp
   ImageCache.cpp
   ImageCache.hpp
+  JsonStreamWriter.cpp
+  JsonStreamWriter.hpp
   Main.cpp
   MaxRectsBinPack.cpp
   MaxRectsBinPack.hpp
+  MipmapGenerator.cpp
+  MipmapGenerator.hpp
+  PageGroup.cpp
+  PageGroup.hpp
+  PngEncoder.cpp
+  PngEncoder.hpp
+  QoiEncoder.cpp
+  QoiEncoder.hpp
   QtImageUtil.cpp
   QtImageUtil.hpp
   QtStringUtil.cpp
   QtStringUtil.hpp
+  TextureContainer.cpp
+  TextureContainer.hpp
   widgets/AngleDial.cpp
   widgets/AngleDial.hpp
   widgets/CharacterSetSelectionWidget.cpp
@@ -4,7 +4,7 @@
 
 #include "FontEditorWidget.hpp"
 
-#include "FontGenWorkerThread.hpp"
+#include "FontExportWorkerThread.hpp"
 #include "FontModel.hpp"
 #include "TextPreviewWidget.hpp"
 #include "ui_FontEditorWidget.h"
@@ -30,6 +30,11 @@ FontEditorWidget::FontEditorWidget(QWidget* parent, const QString& font_filename
 
     m_font_gen_context = std::make_unique<FontGenContext>(&m_all_characters);
 
+    connect(m_font_gen_context.get(),
+            &FontGenContext::progress_changed,
+            this,
+            &FontEditorWidget::font_generation_progress);
+
     ui->fontWidget->set_font_model(m_font);
 
     connect(m_font, &FontModel::properties_changed, this, [this] {
@@ -59,6 +64,13 @@ FontEditorWidget::FontEditorWidget(QWidget* parent, const QString& font_filename
 
 FontEditorWidget::~FontEditorWidget()
 {
+    // The export reads the font model, which is destroyed along with the editor.
+    if (m_export_worker_thread != nullptr)
+    {
+        m_export_worker_thread->cancel();
+        m_export_worker_thread->wait();
+    }
+
     qDebug("Font editor '%s' destroyed", qPrintable(m_font->name()));
 }
 
@@ -81,6 +93,8 @@ void FontEditorWidget::generate_preview_font()
         chars.insert(ch);
     }
 
+    m_font_gen_context->clear_cancellation();
+
     const std::shared_ptr<GeneratedFont> generated_font =
         m_font_gen_context->generate_font(*m_font, chars);
 
@@ -117,40 +131,84 @@ void FontEditorWidget::export_font()
 {
     qDebug("Exporting font");
 
-    gsl::owner<FontGenWorkerThread*> worker_thread =
-        new FontGenWorkerThread(m_font, m_font_gen_context.get());
+    if (m_export_worker_thread != nullptr)
+    {
+        return;
+    }
+
+    const QString font_size_str = QString::number(m_font->qfont().pixelSize());
+
+    QString output_dir{m_font->export_directory()};
+    {
+        output_dir.replace("$(FONT_NAME)", m_font->name());
+        output_dir.replace("$(FONT_SIZE)", font_size_str);
+        output_dir = QDir::cleanPath(m_font->directory() + QDir::separator() + output_dir);
+    }
 
-    connect(worker_thread,
-            &FontGenWorkerThread::started,
+    const FontExportOptions options{
+        .description_type           = m_font->desc_type(),
+        .image_type                 = m_font->image_type(),
+        .flip_images_upside_down    = m_font->should_flip_images_upside_down(),
+        .premultiplied_alpha        = m_font->premultiplied_alpha(),
+        .allow_monochromatic_images = m_font->allow_monochromatic_images(),
+        .png                        = {.compression_level = m_font->png_compression_level(),
+                                       .allow_palette     = m_font->use_png_palette()},
+        .compress_bundle_pages      = m_font->compress_bundle_pages(),
+        .compact_descriptors        = m_font->compact_descriptors(),
+        .header_pixel_format        = m_font->header_pixel_format(),
+        .bundle_gray_format         = m_font->bundle_gray_format(),
+        .pack_monochromatic_pages   = m_font->pack_monochromatic_pages(),
+        .generate_mipmaps           = m_font->generate_mipmaps(),
+    };
+
+    // Canceling the worker cancels the context, from the moment the worker exists.
+    m_font_gen_context->clear_cancellation();
+
+    m_export_worker_thread =
+        new FontExportWorkerThread(m_font, m_font_gen_context.get(), output_dir, options);
+
+    connect(m_export_worker_thread,
+            &FontExportWorkerThread::started,
             this,
             &FontEditorWidget::font_export_started);
 
-    connect(worker_thread, &FontGenWorkerThread::finished, [this, worker_thread] {
-        worker_thread->deleteLater();
-
-        const std::shared_ptr<GeneratedFont> generated_font = worker_thread->generated_font();
+    connect(m_export_worker_thread,
+            &FontExportWorkerThread::progress_changed,
+            this,
+            &FontEditorWidget::font_export_progress);
 
+    connect(m_export_worker_thread, &FontExportWorkerThread::export_succeeded, this, [this] {
         set_is_unsaved(false);
+        emit font_export_done(this);
+    });
 
-        const QString font_size_str = QString::number(m_font->qfont().pixelSize());
+    connect(m_export_worker_thread,
+            &FontExportWorkerThread::export_failed,
+            this,
+            [this](const QString& message) { emit font_export_failed(this, message); });
 
-        QString output_dir{m_font->export_directory()};
-        {
-            output_dir.replace("$(FONT_NAME)", m_font->name());
-            output_dir.replace("$(FONT_SIZE)", font_size_str);
-            output_dir = QDir::cleanPath(m_font->directory() + QDir::separator() + output_dir);
-        }
+    connect(m_export_worker_thread, &FontExportWorkerThread::export_canceled, this, [this] {
+        emit font_export_canceled(this);
+    });
 
-        generated_font->export_to_disk(output_dir,
-                                       m_font->desc_type(),
-                                       m_font->image_type(),
-                                       m_font->should_flip_images_upside_down(),
-                                       m_font->allow_monochromatic_images());
+    connect(m_export_worker_thread, &FontExportWorkerThread::finished, this, [this] {
+        m_export_worker_thread = nullptr;
     });
 
-    connect(worker_thread, &FontGenWorkerThread::finished, [this] { emit font_export_done(this); });
+    connect(m_export_worker_thread,
+            &FontExportWorkerThread::finished,
+            m_export_worker_thread,
+            &QObject::deleteLater);
+
+    m_export_worker_thread->start();
+}
 
-    worker_thread->start();
+void FontEditorWidget::cancel_export()
+{
+    if (m_export_worker_thread != nullptr)
+    {
+        m_export_worker_thread->cancel();
+    }
 }
 
 FontModel* FontEditorWidget::font_model()
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "FontGenContext.hpp"
+#include "GeneratedFont.hpp"
 #include <QSet>
 #include <QWidget>
 #include <gsl/pointers>
@@ -18,6 +19,7 @@ class FontEditorWidget;
 QT_END_NAMESPACE
 
 class QTimer;
+class FontExportWorkerThread;
 class FontModel;
 
 class FontEditorWidget : public QWidget
@@ -35,8 +37,12 @@ class FontEditorWidget : public QWidget
 
     void save_font(const QString& filename);
 
+    // Generates and exports the font in the background. Progress and the outcome are reported
+    // via the font_export_*() signals.
     void export_font();
 
+    void cancel_export();
+
     FontModel* font_model();
 
     const FontModel* font_model() const;
@@ -46,8 +52,18 @@ class FontEditorWidget : public QWidget
   signals:
     void font_export_started();
 
+    void font_export_progress(FontExportStage stage, int completed, int total);
+
+    // Progress of every generation, including those of previews.
+    void font_generation_progress(const FontGenProgress& progress);
+
+    // Emitted once all files are written.
     void font_export_done(FontEditorWidget* editor);
 
+    void font_export_failed(FontEditorWidget* editor, const QString& message);
+
+    void font_export_canceled(FontEditorWidget* editor);
+
     void preview_font_generation_done(FontEditorWidget* editor);
 
     void preview_font_generation_error(FontEditorWidget* editor, const std::exception& ex);
@@ -67,4 +83,5 @@ class FontEditorWidget : public QWidget
     QSet<QChar>                     m_all_characters{};
     std::unique_ptr<FontGenContext> m_font_gen_context{};
     uint64_t                        m_generation_count{};
+    FontExportWorkerThread*         m_export_worker_thread{};
 };
@@ -12,6 +12,9 @@ FontImageTypeComboBox::FontImageTypeComboBox(QWidget* parent)
     for (const auto& [key, value] : {
              qMakePair(QStringLiteral("png"), FontExportImageType::Png),
              qMakePair(QStringLiteral("bmp"), FontExportImageType::Bmp),
+             qMakePair(QStringLiteral("dds"), FontExportImageType::Dds),
+             qMakePair(QStringLiteral("ktx2"), FontExportImageType::Ktx2),
+             qMakePair(QStringLiteral("qoi"), FontExportImageType::Qoi),
          })
     {
         addItem(key, static_cast<int>(value));
@@ -5,10 +5,10 @@
 #include "FontWidget.hpp"
 
 #include "FontModel.hpp"
-#include "FontGenWorkerThread.hpp"
 #include "ui_FontWidget.h"
 #include "windows/CharacterSetsDialog.hpp"
 #include "windows/FontVariationDialog.hpp"
+#include <QFileDialog>
 #include <QScrollBar>
 #include <QTimer>
 
@@ -58,11 +58,24 @@ void FontWidget::set_font_model(FontModel* font)
     ui->cmb_max_page_size->setCurrentText(QString::number(m_font->max_page_extent()));
     ui->chk_include_kerning->setChecked(m_font->use_kerning());
     ui->chk_anti_aliasing->setChecked(m_font->anti_aliasing());
+    ui->cmb_page_grouping->setCurrentIndex(static_cast<int>(m_font->page_grouping()));
+    ui->txt_page_groups->setText(m_font->page_groups());
+    ui->txt_frequency_corpus->setText(m_font->frequency_corpus_filename());
+    ui->chk_coverage_channels->setChecked(m_font->coverage_channels());
 
     ui->cmb_font_desc_type->setCurrentIndex(static_cast<int>(m_font->desc_type()));
     ui->cmb_image_type->set_font_image_type(m_font->image_type());
     ui->chk_flip_images_upside_down->setChecked(m_font->should_flip_images_upside_down());
+    ui->cmb_premultiplied_alpha->setCurrentIndex(static_cast<int>(m_font->premultiplied_alpha()));
     ui->chk_allow_monochromatic_images->setChecked(m_font->allow_monochromatic_images());
+    ui->num_png_compression_level->setValue(m_font->png_compression_level());
+    ui->chk_png_palette->setChecked(m_font->use_png_palette());
+    ui->chk_compress_bundle_pages->setChecked(m_font->compress_bundle_pages());
+    ui->chk_compact_descriptors->setChecked(m_font->compact_descriptors());
+    ui->cmb_header_pixel_format->setCurrentIndex(static_cast<int>(m_font->header_pixel_format()));
+    ui->chk_pack_monochromatic_pages->setChecked(m_font->pack_monochromatic_pages());
+    ui->cmb_bundle_gray_format->setCurrentIndex(static_cast<int>(m_font->bundle_gray_format()));
+    ui->chk_generate_mipmaps->setChecked(m_font->generate_mipmaps());
     ui->txt_output_directory->setText(m_font->export_directory());
 
     ui->fill_options_widget->set_font_model(m_font, m_font->base_fill());
@@ -97,6 +110,7 @@ void FontWidget::set_font_model(FontModel* font)
     }
 
     update_visibility_of_font_desc_type_dependent_widgets();
+    update_visibility_of_page_grouping_dependent_widgets();
 }
 
 void FontWidget::on_max_page_extent_changed()
@@ -134,6 +148,49 @@ void FontWidget::on_anti_aliasing_changed()
     m_font->set_anti_aliasing(ui->chk_anti_aliasing->isChecked());
 }
 
+void FontWidget::on_page_grouping_changed()
+{
+    qDebug("Page grouping changed");
+    m_font->set_page_grouping(static_cast<PageGrouping>(ui->cmb_page_grouping->currentIndex()));
+    update_visibility_of_page_grouping_dependent_widgets();
+}
+
+void FontWidget::on_page_groups_changed()
+{
+    qDebug("Page groups changed");
+    m_font->set_page_groups(ui->txt_page_groups->text());
+}
+
+void FontWidget::on_frequency_corpus_changed()
+{
+    qDebug("Frequency corpus changed");
+    m_font->set_frequency_corpus_filename(ui->txt_frequency_corpus->text());
+}
+
+void FontWidget::on_browse_frequency_corpus_clicked()
+{
+    const QString filename =
+        QFileDialog::getOpenFileName(this,
+                                     QStringLiteral("Open"),
+                                     m_font->directory(),
+                                     QStringLiteral("Text file (*.txt);;All files (*)"),
+                                     nullptr);
+
+    if (filename.isEmpty())
+    {
+        return;
+    }
+
+    ui->txt_frequency_corpus->setText(m_font->relative_filename(filename));
+    m_font->set_frequency_corpus_filename(ui->txt_frequency_corpus->text());
+}
+
+void FontWidget::on_coverage_channels_changed()
+{
+    qDebug("Coverage channels changed");
+    m_font->set_coverage_channels(ui->chk_coverage_channels->isChecked());
+}
+
 void FontWidget::on_stroke_cap_style_changed(int index)
 {
     Q_UNUSED(index);
@@ -200,6 +257,7 @@ void FontWidget::on_font_image_type_changed()
 {
     qDebug("Font image type changed");
     m_font->set_image_type(ui->cmb_image_type->image_type());
+    update_visibility_of_image_type_dependent_widgets();
 }
 
 void FontWidget::on_flip_images_upside_down_changed()
@@ -208,12 +266,70 @@ void FontWidget::on_flip_images_upside_down_changed()
     m_font->set_should_flip_images_upside_down(ui->chk_flip_images_upside_down->isChecked());
 }
 
+void FontWidget::on_premultiplied_alpha_changed()
+{
+    qDebug("Premultiplied alpha changed");
+    m_font->set_premultiplied_alpha(
+        static_cast<PremultipliedAlpha>(ui->cmb_premultiplied_alpha->currentIndex()));
+}
+
 void FontWidget::on_allow_monochromatic_images_changed()
 {
     qDebug("Allow monochromatic images changed");
     m_font->set_allow_monochromatic_images(ui->chk_allow_monochromatic_images->isChecked());
 }
 
+void FontWidget::on_png_compression_level_changed()
+{
+    const int value = ui->num_png_compression_level->value();
+    qDebug("Changed PNG compression level to: %d", value);
+    m_font->set_png_compression_level(value);
+}
+
+void FontWidget::on_png_palette_changed()
+{
+    qDebug("PNG palette changed");
+    m_font->set_use_png_palette(ui->chk_png_palette->isChecked());
+}
+
+void FontWidget::on_compress_bundle_pages_changed()
+{
+    qDebug("Compress bundle pages changed");
+    m_font->set_compress_bundle_pages(ui->chk_compress_bundle_pages->isChecked());
+}
+
+void FontWidget::on_compact_descriptors_changed()
+{
+    qDebug("Compact descriptors changed");
+    m_font->set_compact_descriptors(ui->chk_compact_descriptors->isChecked());
+}
+
+void FontWidget::on_header_pixel_format_changed()
+{
+    qDebug("Header pixel format changed");
+    m_font->set_header_pixel_format(
+        static_cast<HeaderPixelFormat>(ui->cmb_header_pixel_format->currentIndex()));
+}
+
+void FontWidget::on_pack_monochromatic_pages_changed()
+{
+    qDebug("Pack monochromatic pages changed");
+    m_font->set_pack_monochromatic_pages(ui->chk_pack_monochromatic_pages->isChecked());
+}
+
+void FontWidget::on_bundle_gray_format_changed()
+{
+    qDebug("Bundle gray format changed");
+    m_font->set_bundle_gray_format(
+        static_cast<BundleGrayFormat>(ui->cmb_bundle_gray_format->currentIndex()));
+}
+
+void FontWidget::on_generate_mipmaps_changed()
+{
+    qDebug("Generate mipmaps changed");
+    m_font->set_generate_mipmaps(ui->chk_generate_mipmaps->isChecked());
+}
+
 void FontWidget::on_output_directory_changed()
 {
     qDebug("Font output directory changed");
@@ -242,15 +358,70 @@ void FontWidget::update_visibility_of_font_desc_type_dependent_widgets()
 {
     constexpr auto visible = true;
 
-    ui->lbl_image_type->setVisible(visible);
-    ui->cmb_image_type->setVisible(visible);
+    // Bundles and C++ headers contain the pages themselves, so there are no image files.
+    const bool is_bundle     = m_font->desc_type() == FontDescriptionType::Bundle;
+    const bool is_cpp_header = m_font->desc_type() == FontDescriptionType::CppHeader;
+
+    ui->lbl_image_type->setVisible(!is_bundle && !is_cpp_header);
+    ui->cmb_image_type->setVisible(!is_bundle && !is_cpp_header);
+
+    ui->lbl_compress_bundle_pages->setVisible(is_bundle);
+    ui->chk_compress_bundle_pages->setVisible(is_bundle);
+
+    ui->lbl_bundle_gray_format->setVisible(is_bundle);
+    ui->cmb_bundle_gray_format->setVisible(is_bundle);
+
+    ui->lbl_header_pixel_format->setVisible(is_cpp_header);
+    ui->cmb_header_pixel_format->setVisible(is_cpp_header);
+
+    // Only the JSON and XML descriptions have a compact schema.
+    const bool has_compact_schema = m_font->desc_type() == FontDescriptionType::JSON ||
+                                    m_font->desc_type() == FontDescriptionType::XML;
+
+    ui->lbl_compact_descriptors->setVisible(has_compact_schema);
+    ui->chk_compact_descriptors->setVisible(has_compact_schema);
 
     ui->lbl_flip_images_upside_down->setVisible(visible);
     ui->chk_flip_images_upside_down->setVisible(visible);
 
-    ui->lbl_allow_mono->setVisible(visible);
-    ui->chk_allow_monochromatic_images->setVisible(visible);
+    ui->lbl_premultiplied_alpha->setVisible(visible);
+    ui->cmb_premultiplied_alpha->setVisible(visible);
+
+    // C++ headers choose their pixel format explicitly.
+    ui->lbl_allow_mono->setVisible(!is_cpp_header);
+    ui->chk_allow_monochromatic_images->setVisible(!is_cpp_header);
+
+    // C++ headers are never channel-packed.
+    ui->lbl_pack_monochromatic_pages->setVisible(!is_cpp_header);
+    ui->chk_pack_monochromatic_pages->setVisible(!is_cpp_header);
+
+    // C++ headers only contain the base level.
+    ui->lbl_generate_mipmaps->setVisible(!is_cpp_header);
+    ui->chk_generate_mipmaps->setVisible(!is_cpp_header);
 
     ui->lbl_output_directory->setVisible(visible);
     ui->txt_output_directory->setVisible(visible);
+
+    update_visibility_of_image_type_dependent_widgets();
+}
+
+void FontWidget::update_visibility_of_page_grouping_dependent_widgets()
+{
+    const bool visible = m_font->page_grouping() == PageGrouping::Custom;
+
+    ui->lbl_page_groups->setVisible(visible);
+    ui->txt_page_groups->setVisible(visible);
+}
+
+void FontWidget::update_visibility_of_image_type_dependent_widgets()
+{
+    const bool is_png = m_font->image_type() == FontExportImageType::Png &&
+                        m_font->desc_type() != FontDescriptionType::Bundle &&
+                        m_font->desc_type() != FontDescriptionType::CppHeader;
+
+    ui->lbl_png_compression_level->setVisible(is_png);
+    ui->num_png_compression_level->setVisible(is_png);
+
+    ui->lbl_png_palette->setVisible(is_png);
+    ui->chk_png_palette->setVisible(is_png);
 }
@@ -48,6 +48,16 @@ class FontWidget : public QWidget
 
     void on_anti_aliasing_changed();
 
+    void on_page_grouping_changed();
+
+    void on_page_groups_changed();
+
+    void on_frequency_corpus_changed();
+
+    void on_browse_frequency_corpus_clicked();
+
+    void on_coverage_channels_changed();
+
     void on_stroke_cap_style_changed(int index);
 
     void on_stroke_join_style_changed(int index);
@@ -68,8 +78,26 @@ class FontWidget : public QWidget
 
     void on_flip_images_upside_down_changed();
 
+    void on_premultiplied_alpha_changed();
+
     void on_allow_monochromatic_images_changed();
 
+    void on_png_compression_level_changed();
+
+    void on_png_palette_changed();
+
+    void on_compress_bundle_pages_changed();
+
+    void on_compact_descriptors_changed();
+
+    void on_header_pixel_format_changed();
+
+    void on_pack_monochromatic_pages_changed();
+
+    void on_bundle_gray_format_changed();
+
+    void on_generate_mipmaps_changed();
+
     void on_output_directory_changed();
 
     void on_edit_char_sets_clicked();
@@ -81,6 +109,10 @@ class FontWidget : public QWidget
   private:
     void update_visibility_of_font_desc_type_dependent_widgets();
 
+    void update_visibility_of_page_grouping_dependent_widgets();
+
+    void update_visibility_of_image_type_dependent_widgets();
+
     Ui::FontWidget* ui{};
     FontModel*      m_font{};
 };
@@ -4,6 +4,7 @@
 
 #include "CharacterSetsDialog.hpp"
 
+#include "CharacterSet.hpp"
 #include "FontModel.hpp"
 #include "ui_CharacterSetsDialog.h"
 #include "widgets/CharacterSetSelectionWidget.hpp"
@@ -19,27 +20,6 @@ CharacterSetsDialog::CharacterSetsDialog(QWidget* parent, FontModel* font)
     , m_ui(new Ui::CharacterSetsDialog)
     , m_font(font)
 {
-    m_char_set_list = {
-        {.name = QStringLiteral("Basic Latin"), .range_start = 32U, .range_end = 127U},
-        {.name = QStringLiteral("Latin-1 Supplement"), .range_start = 160U, .range_end = 255U},
-        {.name = QStringLiteral("Latin Extended A"), .range_start = 256U, .range_end = 383U},
-        {.name = QStringLiteral("Latin Extended B"), .range_start = 384U, .range_end = 591U},
-        {.name = QStringLiteral("IPA Extensions"), .range_start = 592U, .range_end = 687U},
-        {.name        = QStringLiteral("Spacing Modifier Letters"),
-         .range_start = 688U,
-         .range_end   = 767U},
-        {.name        = QStringLiteral("Combining Diacritical Marks"),
-         .range_start = 768U,
-         .range_end   = 879U},
-        {.name = QStringLiteral("Greek / Coptic"), .range_start = 880U, .range_end = 1023U},
-        {.name = QStringLiteral("Cyrillic"), .range_start = 1024U, .range_end = 1279U},
-        {.name = QStringLiteral("Cyrillic Supplement"), .range_start = 1280U, .range_end = 1327U},
-        {.name = QStringLiteral("Armenian"), .range_start = 1328U, .range_end = 1423U},
-        {.name = QStringLiteral("Hebrew"), .range_start = 1424U, .range_end = 1535U},
-        {.name = QStringLiteral("Arabic"), .range_start = 1536U, .range_end = 1791U},
-        {.name = QStringLiteral("Syriac"), .range_start = 1792U, .range_end = 1871U},
-    };
-
     m_ui->setupUi(this);
 
     {
@@ -130,16 +110,22 @@ void CharacterSetsDialog::accept()
 
 void CharacterSetsDialog::populate_char_sets_list_widget()
 {
-    for (const CharacterSet& char_set : m_char_set_list)
+    for (const CharacterSet& char_set : CharacterSet::unicode_blocks())
     {
+        const QSet<QChar> char_set_chars = char_set.chars();
+
+        // Blocks such as the surrogates have no characters of their own.
+        if (char_set_chars.isEmpty())
+        {
+            continue;
+        }
+
         auto item = std::make_unique<QListWidgetItem>();
         item->setText(char_set.name);
         item->setToolTip(tr("Range %1 - %2").arg(char_set.range_start).arg(char_set.range_end));
         item->setData(Qt::UserRole, QVariant::fromValue(static_cast<const void*>(&char_set)));
         item->setFlags(item->flags() | Qt::ItemFlag::ItemIsUserCheckable);
 
-        const QSet<QChar> char_set_chars = char_set.chars();
-
         const auto check_state = [&] {
             bool has_at_least_one_char = false;
             for (const QChar ch : char_set_chars)
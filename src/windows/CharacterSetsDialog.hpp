@@ -50,5 +50,4 @@ class CharacterSetsDialog : public QDialog
     Ui::CharacterSetsDialog* m_ui{};
     FontModel*                    m_font{};
     QSet<QChar>              m_chars_backup;
-    QList<CharacterSet>      m_char_set_list;
 };
@@ -15,6 +15,7 @@
 #include <QFileDialog>
 #include <QFileSystemWatcher>
 #include <QMessageBox>
+#include <QProgressBar>
 #include <QStandardPaths>
 #include <QStyleHints>
 
@@ -23,6 +24,8 @@ MainWindow::MainWindow(QWidget* parent)
     , m_ui(new Ui::MainWindow)
     , m_waiting_spinner(nullptr)
     , m_prg_bar_font_gen_action(nullptr)
+    , m_export_progress_bar(nullptr)
+    , m_export_progress_bar_action(nullptr)
     , m_status_label(nullptr)
     , m_status_label_action(nullptr)
 {
@@ -116,6 +119,16 @@ void MainWindow::on_export_font_action()
     export_font(current_font_editor());
 }
 
+void MainWindow::on_cancel_export_action()
+{
+    // The tabs are disabled during an export, so the current editor is the exporting one.
+    if (FontEditorWidget* editor = current_font_editor())
+    {
+        editor->cancel_export();
+        m_ui->action_cancel_export->setEnabled(false);
+    }
+}
+
 void MainWindow::on_shared_font_config_changed()
 {
     m_status_label->ShowStatus(tr("Shared font configuration has changed."), 6000);
@@ -141,14 +154,86 @@ void MainWindow::on_font_export_started()
 {
     m_waiting_spinner->start();
     m_prg_bar_font_gen_action->setVisible(true);
+
+    m_export_progress_bar->setRange(0, 0);
+    m_export_progress_bar->setFormat(QString{});
+    m_export_progress_bar_action->setVisible(true);
+
+    m_ui->action_cancel_export->setEnabled(true);
+    m_ui->action_cancel_export->setVisible(true);
+}
+
+void MainWindow::on_font_export_progress(FontExportStage stage, int completed, int total)
+{
+    switch (stage)
+    {
+        case FontExportStage::Generating:
+            m_export_progress_bar->setFormat(tr("Generating glyphs"));
+            break;
+        case FontExportStage::Pages:
+            m_export_progress_bar->setFormat(tr("Encoding pages (%v of %m)"));
+            break;
+        case FontExportStage::Description:
+            m_export_progress_bar->setFormat(tr("Writing files"));
+            break;
+    }
+
+    // Stages of a single step are shown as busy indicators.
+    m_export_progress_bar->setRange(0, total > 1 ? total : 0);
+    m_export_progress_bar->setValue(completed);
+}
+
+void MainWindow::on_font_generation_progress(const FontGenProgress& progress)
+{
+    // Preview generations run on the GUI thread and are too short to be shown.
+    if (!m_export_progress_bar_action->isVisible())
+    {
+        return;
+    }
+
+    const QString glyph_rate = QString::number(qRound(progress.glyphs_per_second));
+
+    switch (progress.stage)
+    {
+        case FontGenStage::Rasterizing:
+            m_export_progress_bar->setFormat(
+                tr("Rasterizing glyphs (%v of %m, %1/s)").arg(glyph_rate));
+            break;
+        case FontGenStage::Packing:
+            m_export_progress_bar->setFormat(
+                tr("Packing glyphs (%v of %m, %1% occupancy)")
+                    .arg(qRound(progress.occupancy * 100.0F)));
+            break;
+        case FontGenStage::Compositing:
+            m_export_progress_bar->setFormat(tr("Compositing pages"));
+            break;
+    }
+
+    m_export_progress_bar->setRange(0, int(progress.total));
+    m_export_progress_bar->setValue(int(progress.completed));
 }
 
 void MainWindow::on_font_export_done(FontEditorWidget* editor)
 {
-    m_waiting_spinner->stop();
-    m_prg_bar_font_gen_action->setVisible(false);
+    end_font_export();
     m_status_label->ShowStatus(tr("Exported font '%1'").arg(editor->font_model()->name()), 3000);
-    m_ui->fonts_tab_widget->setEnabled(true);
+}
+
+void MainWindow::on_font_export_failed(FontEditorWidget* editor, const QString& message)
+{
+    end_font_export();
+    QMessageBox::critical(this,
+                          tr("Error"),
+                          tr("Failed to export the font '%1': %2")
+                              .arg(editor->font_model()->name())
+                              .arg(message));
+}
+
+void MainWindow::on_font_export_canceled(FontEditorWidget* editor)
+{
+    end_font_export();
+    m_status_label->ShowStatus(
+        tr("Canceled the export of font '%1'").arg(editor->font_model()->name()), 3000);
 }
 
 void MainWindow::on_font_editor_save_state_changed(const FontEditorWidget* editor)
@@ -186,10 +271,20 @@ void MainWindow::build_toolbar()
     add_spacer(20);
 
     {
-        m_waiting_spinner         = new WaitingSpinnerWidget();
+        // The toolbar stays enabled while spinning, so that the export can be canceled.
+        m_waiting_spinner         = new WaitingSpinnerWidget(nullptr, true, false);
         m_prg_bar_font_gen_action = m_ui->tool_bar->addWidget(m_waiting_spinner);
     }
 
+    {
+        m_export_progress_bar = new QProgressBar();
+        m_export_progress_bar->setFixedWidth(220);
+        m_export_progress_bar->setTextVisible(true);
+        m_export_progress_bar_action = m_ui->tool_bar->addWidget(m_export_progress_bar);
+    }
+
+    m_ui->tool_bar->addAction(m_ui->action_cancel_export);
+
     add_expander();
 
     {
@@ -210,6 +305,8 @@ void MainWindow::build_toolbar()
     add_spacer(10);
 
     m_prg_bar_font_gen_action->setVisible(false);
+    m_export_progress_bar_action->setVisible(false);
+    m_ui->action_cancel_export->setVisible(false);
 }
 
 void MainWindow::showEvent(QShowEvent* event)
@@ -271,10 +368,26 @@ void MainWindow::open_font(const QString& filename)
             &FontEditorWidget::font_export_started,
             this,
             &MainWindow::on_font_export_started);
+    connect(font_editor,
+            &FontEditorWidget::font_export_progress,
+            this,
+            &MainWindow::on_font_export_progress);
+    connect(font_editor,
+            &FontEditorWidget::font_generation_progress,
+            this,
+            &MainWindow::on_font_generation_progress);
     connect(font_editor,
             &FontEditorWidget::font_export_done,
             this,
             &MainWindow::on_font_export_done);
+    connect(font_editor,
+            &FontEditorWidget::font_export_failed,
+            this,
+            &MainWindow::on_font_export_failed);
+    connect(font_editor,
+            &FontEditorWidget::font_export_canceled,
+            this,
+            &MainWindow::on_font_export_canceled);
 
     m_ui->stacked_widget->setCurrentIndex(0);
 }
@@ -291,17 +404,45 @@ void MainWindow::export_font(FontEditorWidget* editor)
     {
         m_status_label->hide();
         m_ui->fonts_tab_widget->setEnabled(false);
+        set_font_actions_enabled(false);
         editor->save_font(editor->font_model()->filename());
         editor->export_font();
     }
     catch (const std::exception& ex)
     {
+        end_font_export();
         QMessageBox::critical(this,
                               tr("Error"),
                               tr("Failed to export the font: %1").arg(ex.what()));
     }
 }
 
+void MainWindow::end_font_export()
+{
+    m_waiting_spinner->stop();
+    m_prg_bar_font_gen_action->setVisible(false);
+    m_export_progress_bar_action->setVisible(false);
+    m_ui->action_cancel_export->setVisible(false);
+    m_ui->fonts_tab_widget->setEnabled(true);
+    set_font_actions_enabled(true);
+}
+
+void MainWindow::set_font_actions_enabled(bool enabled)
+{
+    m_ui->action_new_font->setEnabled(enabled);
+    m_ui->action_open_font->setEnabled(enabled);
+
+    if (enabled)
+    {
+        update_header_buttons_enabledness();
+    }
+    else
+    {
+        m_ui->action_save_font->setEnabled(false);
+        m_ui->action_export_font->setEnabled(false);
+    }
+}
+
 void MainWindow::closeEvent(QCloseEvent* event)
 {
     if (!handle_unsaved_changes_for_all_editors())
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "FontGenContext.hpp"
+#include "GeneratedFont.hpp"
 #include "widgets/WaitingSpinner.hpp"
 #include <QMainWindow>
 #include <QMenu>
@@ -46,6 +48,8 @@ class MainWindow : public QMainWindow
 
     void on_export_font_action();
 
+    void on_cancel_export_action();
+
     void on_shared_font_config_changed();
 
     void on_tab_close_requested(int index);
@@ -54,8 +58,16 @@ class MainWindow : public QMainWindow
 
     void on_font_export_started();
 
+    void on_font_export_progress(FontExportStage stage, int completed, int total);
+
+    void on_font_generation_progress(const FontGenProgress& progress);
+
     void on_font_export_done(FontEditorWidget* editor);
 
+    void on_font_export_failed(FontEditorWidget* editor, const QString& message);
+
+    void on_font_export_canceled(FontEditorWidget* editor);
+
     void on_font_editor_save_state_changed(const FontEditorWidget* editor);
 
   private:
@@ -71,6 +83,11 @@ class MainWindow : public QMainWindow
 
     void export_font(FontEditorWidget* editor);
 
+    // Restores the toolbar and the tabs after an export, however it ended.
+    void end_font_export();
+
+    void set_font_actions_enabled(bool enabled);
+
     void closeEvent(QCloseEvent* event) override;
 
     void close_font(gsl::owner<FontEditorWidget*> editor);
@@ -88,6 +105,8 @@ class MainWindow : public QMainWindow
     Ui::MainWindow*                   m_ui;
     gsl::owner<WaitingSpinnerWidget*> m_waiting_spinner;
     QAction*                          m_prg_bar_font_gen_action;
+    gsl::owner<QProgressBar*>         m_export_progress_bar;
+    QAction*                          m_export_progress_bar_action;
     gsl::owner<StatusLabel*>          m_status_label;
     QAction*                          m_status_label_action;
 };
@@ -0,0 +1,143 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "BinaryFontFormat.hpp"
+#include "GeneratedFont.hpp"
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+#include <algorithm>
+#include <cstring>
+
+namespace bf = bmfgen::binary_format;
+
+// Reads a value of the mapped descriptor, as a loader would.
+template <typename T>
+static T read_at(const QByteArray& data, qsizetype offset)
+{
+    T value{};
+    std::memcpy(&value, data.constData() + offset, sizeof(T));
+    return value;
+}
+
+// Looks up a code point in the two-level index of a variation, as documented in
+// BinaryFontFormat.hpp.
+static uint32_t find_glyph(const QByteArray&         data,
+                           const bf::VariationEntry& variation,
+                           uint32_t                  code_point)
+{
+    const qsizetype level1_offset = variation.index_offset;
+    const qsizetype blocks_offset = level1_offset + 256 * qsizetype(sizeof(uint16_t));
+
+    const auto block = read_at<uint16_t>(data, level1_offset + (code_point >> 8) * 2);
+
+    if (block == bf::no_index_block)
+    {
+        return bf::no_glyph;
+    }
+
+    const qsizetype entry = qsizetype(block) * 256 + (code_point & 0xFF);
+
+    return read_at<uint32_t>(data, blocks_offset + entry * qsizetype(sizeof(uint32_t)));
+}
+
+class TestBinaryDescriptor : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void index_finds_every_glyph()
+    {
+        // Code points in three high-byte blocks, most of them sharing the first one.
+        const QList<QChar> characters{
+            QChar{u'A'}, QChar{u'z'}, QChar{u'\u00E9'}, QChar{u'\u0416'}, QChar{u'\u4E00'}};
+
+        QList<Glyph>     glyphs;
+        QList<qsizetype> glyph_indices;
+        FontPage         page{QSize{64, 64}};
+
+        for (qsizetype i = 0; i < characters.size(); ++i)
+        {
+            Glyph glyph;
+            glyph.character          = characters[i];
+            glyph.rect               = QRect{int(i) * 8, 0, 8, 8};
+            glyph.horizontal_advance = 8;
+
+            glyphs.append(glyph);
+            glyph_indices.append(i);
+            page.glyph_indices.append(i);
+        }
+
+        // The variation lists its glyphs in a different order than the font.
+        std::reverse(glyph_indices.begin(), glyph_indices.end());
+
+        const GeneratedFont font{
+            "IndexTest",
+            16,
+            true,
+            0,
+            QSet<QChar>{characters.begin(), characters.end()},
+            glyphs,
+            {GeneratedFont::Variation{.scale_factor = 1.0, .glyph_indices = glyph_indices}},
+            {page},
+            {}};
+
+        QTemporaryDir directory;
+        QVERIFY(directory.isValid());
+
+        font.export_to_disk(directory.path(),
+                            FontExportOptions{
+                                .description_type = FontDescriptionType::Binary,
+                                .image_type       = FontExportImageType::Png,
+                            });
+
+        QFile file{QDir{directory.path()}.filePath("IndexTest.bin")};
+        QVERIFY(file.open(QFile::ReadOnly));
+
+        const QByteArray data = file.readAll();
+
+        QVERIFY(data.size() >= qsizetype(sizeof(bf::FileHeader)));
+
+        const auto header = read_at<bf::FileHeader>(data, 0);
+
+        QVERIFY(std::memcmp(header.magic, bf::magic.data(), bf::magic.size()) == 0);
+        QCOMPARE(header.version, bf::version);
+        QCOMPARE(qsizetype(header.file_size), data.size());
+        QCOMPARE(header.glyph_count, uint32_t(glyphs.size()));
+        QCOMPARE(header.variation_count, 1U);
+        QCOMPARE(header.variation_table_offset % bf::section_alignment, 0U);
+
+        const auto variation = read_at<bf::VariationEntry>(data, header.variation_table_offset);
+
+        QCOMPARE(variation.glyph_count, uint32_t(glyph_indices.size()));
+        QCOMPARE(variation.index_offset % bf::section_alignment, 0U);
+
+        // Three distinct high bytes: 0x00, 0x04 and 0x4E.
+        QCOMPARE(variation.index_block_count, 3U);
+
+        const auto glyph_table = read_at<bf::GlyphTable>(data, header.glyph_table_offset);
+
+        const auto code_point_at = [&](uint32_t glyph_index) {
+            return read_at<uint32_t>(data, glyph_table.code_points_offset + glyph_index * 4);
+        };
+
+        for (qsizetype i = 0; i < glyphs.size(); ++i)
+        {
+            const uint32_t code_point  = characters[i].unicode();
+            const uint32_t glyph_index = find_glyph(data, variation, code_point);
+
+            QCOMPARE(glyph_index, uint32_t(i));
+            QCOMPARE(code_point_at(glyph_index), code_point);
+        }
+
+        // Missing in a present block and in an absent block.
+        QCOMPARE(find_glyph(data, variation, u'B'), bf::no_glyph);
+        QCOMPARE(find_glyph(data, variation, 0x3000), bf::no_glyph);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestBinaryDescriptor)
+
+#include "TestBinaryDescriptor.moc"
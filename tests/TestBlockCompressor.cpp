@@ -0,0 +1,308 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "BlockCompressor.hpp"
+#include <QImage>
+#include <QTest>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <type_traits>
+
+using GrayBlock = std::array<uint8_t, 16>;
+using RgbaBlock = std::array<std::array<uint8_t, 4>, 16>;
+
+// Reads bits of a block, least significant bit of the first byte first.
+class BitReader
+{
+  public:
+    explicit BitReader(const uchar* data)
+        : m_data(data)
+    {
+    }
+
+    int read(int count)
+    {
+        int value = 0;
+
+        for (int i = 0; i < count; ++i, ++m_position)
+        {
+            const int bit = (m_data[m_position / 8] >> (m_position % 8)) & 1;
+            value |= bit << i;
+        }
+
+        return value;
+    }
+
+  private:
+    const uchar* m_data;
+    int          m_position{};
+};
+
+// Reference BC4 decoder, as specified by Direct3D.
+static GrayBlock decode_bc4(const uchar* data)
+{
+    BitReader bits{data};
+
+    const int e0 = bits.read(8);
+    const int e1 = bits.read(8);
+
+    std::array<int, 8> palette{e0, e1};
+
+    if (e0 > e1)
+    {
+        for (int i = 1; i < 7; ++i)
+        {
+            palette[i + 1] = ((7 - i) * e0 + i * e1) / 7;
+        }
+    }
+    else
+    {
+        for (int i = 1; i < 5; ++i)
+        {
+            palette[i + 1] = ((5 - i) * e0 + i * e1) / 5;
+        }
+
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    GrayBlock block{};
+
+    for (uint8_t& value : block)
+    {
+        value = uint8_t(palette[bits.read(3)]);
+    }
+
+    return block;
+}
+
+// Reference BC7 decoder for mode 6, the only mode that the compressor writes.
+static RgbaBlock decode_bc7_mode6(const uchar* data)
+{
+    static constexpr std::array<int, 16> weights = {
+        0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    BitReader bits{data};
+
+    // Mode 6 is a single one bit after six zero bits.
+    if (bits.read(7) != 0x40)
+    {
+        return {};
+    }
+
+    std::array<std::array<int, 4>, 2> endpoints{};
+
+    for (int c = 0; c < 4; ++c)
+    {
+        endpoints[0][c] = bits.read(7) << 1;
+        endpoints[1][c] = bits.read(7) << 1;
+    }
+
+    const int p0 = bits.read(1);
+    const int p1 = bits.read(1);
+
+    for (int c = 0; c < 4; ++c)
+    {
+        endpoints[0][c] |= p0;
+        endpoints[1][c] |= p1;
+    }
+
+    RgbaBlock block{};
+
+    for (int i = 0; i < 16; ++i)
+    {
+        // The anchor index omits its most significant bit, which is always zero.
+        const int w = weights[bits.read(i == 0 ? 3 : 4)];
+
+        for (int c = 0; c < 4; ++c)
+        {
+            block[i][c] =
+                uint8_t(((64 - w) * endpoints[0][c] + w * endpoints[1][c] + 32) >> 6);
+        }
+    }
+
+    return block;
+}
+
+// Returns the largest difference between a decoded block and the image it was compressed from.
+// Pixels outside of the image repeat its edges.
+template <typename Block>
+static int max_block_error(const QImage& image, int block_x, int block_y, const Block& block)
+{
+    int max_error = 0;
+
+    for (int y = 0; y < 4; ++y)
+    {
+        const int    src_y = std::min(block_y * 4 + y, image.height() - 1);
+        const uchar* row   = image.constScanLine(src_y);
+
+        for (int x = 0; x < 4; ++x)
+        {
+            const int src_x = std::min(block_x * 4 + x, image.width() - 1);
+
+            if constexpr (std::is_same_v<Block, GrayBlock>)
+            {
+                const int diff = int(row[src_x]) - int(block[y * 4 + x]);
+                max_error      = std::max(max_error, std::abs(diff));
+            }
+            else
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    const int diff = int(row[src_x * 4 + c]) - int(block[y * 4 + x][c]);
+                    max_error      = std::max(max_error, std::abs(diff));
+                }
+            }
+        }
+    }
+
+    return max_error;
+}
+
+class TestBlockCompressor : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void bc4_blocks_are_stored_row_by_row()
+    {
+        // 3x2 blocks with a distinct value each, and a partial last row and column.
+        QImage image{10, 7, QImage::Format_Grayscale8};
+
+        for (int y = 0; y < image.height(); ++y)
+        {
+            for (int x = 0; x < image.width(); ++x)
+            {
+                image.scanLine(y)[x] = uchar((y / 4 * 3 + x / 4) * 40);
+            }
+        }
+
+        const QByteArray data = BlockCompressor::compress_bc4(image);
+
+        QCOMPARE(data.size(), BlockCompressor::compressed_size(BlockFormat::Bc4, 10, 7));
+        QCOMPARE(data.size(), qsizetype(3 * 2 * 8));
+
+        const auto* blocks = reinterpret_cast<const uchar*>(data.constData());
+
+        for (int block_y = 0; block_y < 2; ++block_y)
+        {
+            for (int block_x = 0; block_x < 3; ++block_x)
+            {
+                const GrayBlock block = decode_bc4(blocks + (block_y * 3 + block_x) * 8);
+
+                // Flat blocks are exact.
+                QCOMPARE(max_block_error(image, block_x, block_y, block), 0);
+            }
+        }
+    }
+
+    void bc4_keeps_transparent_and_opaque_exact()
+    {
+        QImage image{4, 4, QImage::Format_Grayscale8};
+
+        for (int y = 0; y < 4; ++y)
+        {
+            for (int x = 0; x < 4; ++x)
+            {
+                static constexpr std::array<uchar, 4> values{0, 96, 160, 255};
+                image.scanLine(y)[x] = values[(x + y) % 4];
+            }
+        }
+
+        const QByteArray data  = BlockCompressor::compress_bc4(image);
+        const GrayBlock  block = decode_bc4(reinterpret_cast<const uchar*>(data.constData()));
+
+        // The six-value mode has exact 0 and 255, and the values in between become its
+        // endpoints, so the block is lossless.
+        QCOMPARE(max_block_error(image, 0, 0, block), 0);
+    }
+
+    void bc7_writes_mode6_blocks_row_by_row()
+    {
+        QImage image{8, 8, QImage::Format_RGBA8888};
+
+        const std::array<QColor, 4> colors{
+            QColor{255, 0, 0, 255},
+            QColor{0, 128, 255, 255},
+            QColor{10, 200, 30, 64},
+            QColor{255, 255, 255, 0},
+        };
+
+        for (int y = 0; y < 8; ++y)
+        {
+            for (int x = 0; x < 8; ++x)
+            {
+                const QColor& color = colors[y / 4 * 2 + x / 4];
+                uchar*        pixel = image.scanLine(y) + x * 4;
+
+                pixel[0] = uchar(color.red());
+                pixel[1] = uchar(color.green());
+                pixel[2] = uchar(color.blue());
+                pixel[3] = uchar(color.alpha());
+            }
+        }
+
+        const QByteArray data = BlockCompressor::compress_bc7(image);
+
+        QCOMPARE(data.size(), BlockCompressor::compressed_size(BlockFormat::Bc7, 8, 8));
+        QCOMPARE(data.size(), qsizetype(4 * 16));
+
+        const auto* blocks = reinterpret_cast<const uchar*>(data.constData());
+
+        for (int block_y = 0; block_y < 2; ++block_y)
+        {
+            for (int block_x = 0; block_x < 2; ++block_x)
+            {
+                const uchar* block_data = blocks + (block_y * 2 + block_x) * 16;
+
+                QCOMPARE(int(block_data[0] & 0x7F), 0x40);
+
+                // Endpoints have 7 bits and a p-bit that is shared by all channels, which can
+                // be off by one for flat colors whose channels differ in parity.
+                const RgbaBlock block = decode_bc7_mode6(block_data);
+                QVERIFY(max_block_error(image, block_x, block_y, block) <= 1);
+            }
+        }
+    }
+
+    void bc7_approximates_gradients()
+    {
+        // Mode 6 interpolates along a single line, which a diagonal ramp lies on.
+        QImage image{6, 5, QImage::Format_RGBA8888};
+
+        for (int y = 0; y < image.height(); ++y)
+        {
+            for (int x = 0; x < image.width(); ++x)
+            {
+                const int t     = x + y;
+                uchar*    pixel = image.scanLine(y) + x * 4;
+
+                pixel[0] = uchar(t * 20);
+                pixel[1] = uchar(255 - t * 20);
+                pixel[2] = uchar(t * 10);
+                pixel[3] = uchar(255 - t * 15);
+            }
+        }
+
+        const QByteArray data = BlockCompressor::compress_bc7(image);
+
+        QCOMPARE(data.size(), qsizetype(2 * 2 * 16));
+
+        const auto* blocks = reinterpret_cast<const uchar*>(data.constData());
+
+        for (int block_y = 0; block_y < 2; ++block_y)
+        {
+            for (int block_x = 0; block_x < 2; ++block_x)
+            {
+                const RgbaBlock block = decode_bc7_mode6(blocks + (block_y * 2 + block_x) * 16);
+                QVERIFY(max_block_error(image, block_x, block_y, block) <= 6);
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(TestBlockCompressor)
+
+#include "TestBlockCompressor.moc"
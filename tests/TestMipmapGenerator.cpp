@@ -0,0 +1,172 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "MipmapGenerator.hpp"
+#include <QTest>
+#include <algorithm>
+
+struct ChannelRegion
+{
+    QRect rect;
+    int   channel{};
+};
+
+// Returns an RGBA8888 image whose channels are covered by the specified regions, each filled
+// with a pattern of its own.
+static QImage make_packed_image(QSize size, const QList<ChannelRegion>& regions)
+{
+    QImage image{size, QImage::Format_RGBA8888};
+    image.fill(0);
+
+    for (qsizetype i = 0; i < regions.size(); ++i)
+    {
+        const ChannelRegion& region = regions[i];
+
+        for (int y = region.rect.top(); y <= region.rect.bottom(); ++y)
+        {
+            for (int x = region.rect.left(); x <= region.rect.right(); ++x)
+            {
+                const int value = 96 + int(x * 13 + y * 7 + i * 29) % 160;
+
+                image.scanLine(y)[x * 4 + region.channel] = uchar(value);
+            }
+        }
+    }
+
+    return image;
+}
+
+// Returns an image that only holds a single channel of another one, in all of its channels.
+static QImage extract_channel(const QImage& image, int channel)
+{
+    QImage result{image.size(), QImage::Format_RGBA8888};
+
+    for (int y = 0; y < image.height(); ++y)
+    {
+        for (int x = 0; x < image.width(); ++x)
+        {
+            const uchar value = image.constScanLine(y)[x * 4 + channel];
+            std::fill_n(result.scanLine(y) + x * 4, 4, value);
+        }
+    }
+
+    return result;
+}
+
+class TestMipmapGenerator : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void level_sizes_halve_down_to_one()
+    {
+        QImage image{13, 6, QImage::Format_RGBA8888};
+        image.fill(0);
+
+        const QList<QImage> levels = MipmapGenerator::generate(image, {});
+
+        QCOMPARE(levels.size(), qsizetype(MipmapGenerator::level_count(13, 6)));
+        QCOMPARE(levels[1].size(), QSize(6, 3));
+        QCOMPARE(levels[2].size(), QSize(3, 1));
+        QCOMPARE(levels[3].size(), QSize(1, 1));
+    }
+
+    void packed_channels_are_filtered_independently()
+    {
+        // Regions don't overlap within a channel, but do across channels, as the glyphs of
+        // channel-packed pages do. The page is wide enough for whole blocks of a single owner.
+        const QList<ChannelRegion> regions{
+            {QRect{0, 0, 9, 7}, 0},
+            {QRect{10, 1, 14, 12}, 0},
+            {QRect{3, 2, 8, 9}, 1},
+            {QRect{11, 0, 5, 5}, 1},
+            {QRect{1, 5, 20, 4}, 2},
+            {QRect{0, 0, 32, 3}, 3},
+            {QRect{5, 10, 7, 6}, 3},
+        };
+
+        const QImage image = make_packed_image(QSize{32, 16}, regions);
+
+        QList<QRect> rects;
+        QList<int>   channels;
+
+        for (const ChannelRegion& region : regions)
+        {
+            rects.append(region.rect);
+            channels.append(region.channel);
+        }
+
+        const QList<QImage> levels = MipmapGenerator::generate(image, rects, channels);
+
+        // Each channel must come out as if its page had been mipped on its own.
+        for (int c = 0; c < 4; ++c)
+        {
+            QList<QRect> channel_rects;
+
+            for (const ChannelRegion& region : regions)
+            {
+                if (region.channel == c)
+                {
+                    channel_rects.append(region.rect);
+                }
+            }
+
+            const QList<QImage> expected =
+                MipmapGenerator::generate(extract_channel(image, c), channel_rects);
+
+            QCOMPARE(levels.size(), expected.size());
+
+            for (qsizetype level = 1; level < levels.size(); ++level)
+            {
+                for (int y = 0; y < levels[level].height(); ++y)
+                {
+                    for (int x = 0; x < levels[level].width(); ++x)
+                    {
+                        const int actual = levels[level].constScanLine(y)[x * 4 + c];
+                        const int wanted = expected[level].constScanLine(y)[x * 4 + c];
+
+                        if (actual != wanted)
+                        {
+                            const QString message =
+                                QStringLiteral("Channel %1 of level %2 differs at %3, %4")
+                                    .arg(c)
+                                    .arg(level)
+                                    .arg(x)
+                                    .arg(y);
+
+                            QFAIL(qPrintable(message));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void overlapping_glyph_keeps_its_coverage()
+    {
+        // A G glyph under an R glyph, off the 2x2 grid of level 1. With a single owner per
+        // pixel, the R glyph would own the 2x2 blocks by majority and the G glyph would vanish.
+        QImage image{8, 8, QImage::Format_RGBA8888};
+        image.fill(0);
+
+        for (int y = 1; y < 3; ++y)
+        {
+            for (int x = 1; x < 3; ++x)
+            {
+                image.scanLine(y)[x * 4 + 1] = 255;
+            }
+        }
+
+        const QList<QImage> levels =
+            MipmapGenerator::generate(image, {QRect{0, 0, 8, 8}, QRect{1, 1, 2, 2}}, {0, 1});
+
+        // One of the four samples of each block is covered.
+        QCOMPARE(int(levels[1].constScanLine(0)[0 * 4 + 1]), 64);
+        QCOMPARE(int(levels[1].constScanLine(1)[1 * 4 + 1]), 64);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestMipmapGenerator)
+
+#include "TestMipmapGenerator.moc"
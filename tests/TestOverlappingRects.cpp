@@ -0,0 +1,110 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "MaxRectsBinPack.hpp"
+#include <QRandomGenerator>
+#include <QTest>
+#include <algorithm>
+
+using binpacking::find_overlapping_rects;
+
+// Quadratic reference for find_overlapping_rects().
+static bool has_overlap_brute_force(const QList<QRect>& rects)
+{
+    for (qsizetype i = 0; i < rects.size(); ++i)
+    {
+        for (qsizetype j = i + 1; j < rects.size(); ++j)
+        {
+            if (rects[i].intersects(rects[j]))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+class TestOverlappingRects : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void touching_rects_dont_overlap()
+    {
+        QList<QRect> rects;
+
+        for (int y = 0; y < 4; ++y)
+        {
+            for (int x = 0; x < 4; ++x)
+            {
+                rects.append(QRect{x * 10, y * 10, 10, 10});
+            }
+        }
+
+        QVERIFY(!find_overlapping_rects(rects).has_value());
+    }
+
+    void finds_overlapping_pair()
+    {
+        const QList<QRect> rects{
+            QRect{0, 0, 10, 10},
+            QRect{20, 0, 10, 10},
+            QRect{9, 9, 5, 5},
+        };
+
+        const auto overlap = find_overlapping_rects(rects);
+
+        QVERIFY(overlap.has_value());
+        QCOMPARE(std::min(overlap->first, overlap->second), qsizetype(0));
+        QCOMPARE(std::max(overlap->first, overlap->second), qsizetype(2));
+    }
+
+    void finds_contained_rect()
+    {
+        const QList<QRect> rects{QRect{0, 0, 100, 100}, QRect{40, 40, 2, 2}};
+
+        QVERIFY(find_overlapping_rects(rects).has_value());
+    }
+
+    void ignores_empty_rects()
+    {
+        const QList<QRect> rects{QRect{0, 0, 10, 10}, QRect{5, 5, 0, 0}, QRect{5, 5, 3, 0}};
+
+        QVERIFY(!find_overlapping_rects(rects).has_value());
+    }
+
+    void matches_brute_force()
+    {
+        QRandomGenerator random{1234};
+
+        for (int iteration = 0; iteration < 500; ++iteration)
+        {
+            QList<QRect> rects;
+
+            const int count = random.bounded(1, 24);
+
+            for (int i = 0; i < count; ++i)
+            {
+                rects.append(QRect{random.bounded(64),
+                                   random.bounded(64),
+                                   random.bounded(0, 12),
+                                   random.bounded(0, 12)});
+            }
+
+            const auto overlap = find_overlapping_rects(rects);
+
+            QCOMPARE(overlap.has_value(), has_overlap_brute_force(rects));
+
+            if (overlap)
+            {
+                QVERIFY(rects[overlap->first].intersects(rects[overlap->second]));
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(TestOverlappingRects)
+
+#include "TestOverlappingRects.moc"
@@ -0,0 +1,126 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "PngEncoder.hpp"
+#include <QImage>
+#include <QTest>
+#include <cstring>
+
+// An RGBA8888 image whose pixels cycle through the specified number of colors, including
+// translucent and fully transparent ones.
+static QImage make_rgba_image(int width, int height, int color_count)
+{
+    QImage image{width, height, QImage::Format_RGBA8888};
+
+    for (int y = 0; y < height; ++y)
+    {
+        uchar* row = image.scanLine(y);
+
+        for (int x = 0; x < width; ++x)
+        {
+            const int color = (y * width + x) % color_count;
+
+            row[x * 4 + 0] = uchar(color * 7);
+            row[x * 4 + 1] = uchar(color * 13);
+            row[x * 4 + 2] = uchar(255 - color);
+            row[x * 4 + 3] = uchar(color % 3 == 0 ? 255 : color % 3 == 1 ? 0 : 128);
+        }
+    }
+
+    return image;
+}
+
+// Decodes a PNG and checks that it has the pixels of the image it was encoded from.
+static bool decodes_to(const QByteArray& png, const QImage& expected)
+{
+    const QImage decoded = QImage::fromData(png, "PNG").convertToFormat(expected.format());
+
+    if (decoded.size() != expected.size())
+    {
+        return false;
+    }
+
+    const qsizetype row_size = qsizetype(expected.width()) * (expected.depth() / 8);
+
+    for (int y = 0; y < expected.height(); ++y)
+    {
+        if (std::memcmp(decoded.constScanLine(y), expected.constScanLine(y), size_t(row_size)) != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+class TestPngEncoder : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void rgba_round_trip_data()
+    {
+        QTest::addColumn<int>("color_count");
+        QTest::addColumn<int>("compression_level");
+        QTest::addColumn<bool>("allow_palette");
+
+        // Palettes of 1, 2, 4 and 8 bits, and too many colors for a palette.
+        for (const int color_count : {2, 3, 16, 200, 1000})
+        {
+            for (const int compression_level : {0, 6, 9})
+            {
+                for (const bool allow_palette : {false, true})
+                {
+                    QTest::addRow("%d colors, level %d, palette %d",
+                                  color_count,
+                                  compression_level,
+                                  int(allow_palette))
+                        << color_count << compression_level << allow_palette;
+                }
+            }
+        }
+    }
+
+    void rgba_round_trip()
+    {
+        QFETCH(int, color_count);
+        QFETCH(int, compression_level);
+        QFETCH(bool, allow_palette);
+
+        // An odd width, so that packed palette rows end in partial bytes.
+        const QImage image = make_rgba_image(37, 23, color_count);
+
+        const QByteArray png = PngEncoder::encode(
+            image,
+            PngEncoderOptions{.compression_level = compression_level,
+                              .allow_palette     = allow_palette});
+
+        QVERIFY(png.startsWith("\x89PNG\r\n\x1A\n"));
+        QVERIFY(decodes_to(png, image));
+    }
+
+    void gray_round_trip()
+    {
+        QImage image{29, 31, QImage::Format_Grayscale8};
+
+        for (int y = 0; y < image.height(); ++y)
+        {
+            for (int x = 0; x < image.width(); ++x)
+            {
+                image.scanLine(y)[x] = uchar((x * 9 + y * 5) % 256);
+            }
+        }
+
+        for (const int compression_level : {0, 9})
+        {
+            const PngEncoderOptions options{.compression_level = compression_level};
+
+            QVERIFY(decodes_to(PngEncoder::encode(image, options), image));
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(TestPngEncoder)
+
+#include "TestPngEncoder.moc"
@@ -0,0 +1,208 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "QoiEncoder.hpp"
+#include <QImage>
+#include <QTest>
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <vector>
+
+struct QoiImage
+{
+    int                  width{};
+    int                  height{};
+    int                  channels{};
+    std::vector<uint8_t> pixels; // RGBA
+};
+
+// Reference decoder, following the specification at https://qoiformat.org.
+static std::optional<QoiImage> decode_qoi(const QByteArray& data)
+{
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.constData());
+    const auto  size  = data.size();
+
+    constexpr qsizetype header_size = 14;
+    constexpr qsizetype end_size    = 8;
+
+    if (size < header_size + end_size || !data.startsWith("qoif"))
+    {
+        return std::nullopt;
+    }
+
+    const auto read_u32_be = [&](qsizetype offset) {
+        return int(uint32_t(bytes[offset]) << 24 | uint32_t(bytes[offset + 1]) << 16 |
+                   uint32_t(bytes[offset + 2]) << 8 | uint32_t(bytes[offset + 3]));
+    };
+
+    QoiImage image;
+    image.width    = read_u32_be(4);
+    image.height   = read_u32_be(8);
+    image.channels = bytes[12];
+    image.pixels.resize(size_t(image.width) * size_t(image.height) * 4);
+
+    std::array<std::array<uint8_t, 4>, 64> index{};
+    std::array<uint8_t, 4>                 px{0, 0, 0, 255};
+
+    qsizetype position = header_size;
+    int       run      = 0;
+
+    for (size_t i = 0; i < image.pixels.size(); i += 4)
+    {
+        if (run > 0)
+        {
+            --run;
+        }
+        else
+        {
+            if (position >= size - end_size)
+            {
+                return std::nullopt;
+            }
+
+            const uint8_t b1 = bytes[position++];
+
+            if (b1 == 0xFE)
+            {
+                px[0] = bytes[position++];
+                px[1] = bytes[position++];
+                px[2] = bytes[position++];
+            }
+            else if (b1 == 0xFF)
+            {
+                px[0] = bytes[position++];
+                px[1] = bytes[position++];
+                px[2] = bytes[position++];
+                px[3] = bytes[position++];
+            }
+            else if ((b1 & 0xC0) == 0x00)
+            {
+                px = index[b1];
+            }
+            else if ((b1 & 0xC0) == 0x40)
+            {
+                px[0] = uint8_t(px[0] + ((b1 >> 4) & 3) - 2);
+                px[1] = uint8_t(px[1] + ((b1 >> 2) & 3) - 2);
+                px[2] = uint8_t(px[2] + (b1 & 3) - 2);
+            }
+            else if ((b1 & 0xC0) == 0x80)
+            {
+                const uint8_t b2 = bytes[position++];
+                const int     dg = (b1 & 0x3F) - 32;
+
+                px[0] = uint8_t(px[0] + dg - 8 + ((b2 >> 4) & 0x0F));
+                px[1] = uint8_t(px[1] + dg);
+                px[2] = uint8_t(px[2] + dg - 8 + (b2 & 0x0F));
+            }
+            else
+            {
+                run = b1 & 0x3F;
+            }
+
+            index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64] = px;
+        }
+
+        std::copy(px.begin(), px.end(), image.pixels.begin() + qsizetype(i));
+    }
+
+    static constexpr std::array<uint8_t, 8> end_marker{0, 0, 0, 0, 0, 0, 0, 1};
+
+    if (position != size - end_size ||
+        !std::equal(end_marker.begin(), end_marker.end(), bytes + position))
+    {
+        return std::nullopt;
+    }
+
+    return image;
+}
+
+class TestQoiEncoder : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void rgba_round_trip()
+    {
+        // Rows exercise every operation: long runs (beyond the 62 pixels of a single run),
+        // repeated colors (index), small and medium differences (diff, luma), large jumps
+        // (rgb) and alpha changes (rgba).
+        const auto pixel_at = [](int x, int y) -> std::array<uchar, 4> {
+            const auto c = [](int value) { return uchar(value); };
+
+            switch (y)
+            {
+                case 0: return {10, 20, 30, 255};
+                case 1: return {c(x % 2 == 0 ? 200 : 10), c(x % 3 * 70), 5, 255};
+                case 2: return {c(x), c(x * 2), c(x), 255};
+                case 3: return {c(x * 5), c(x * 7), c(x * 9), 255};
+                case 4: return {c(x * 37), c(x * 101), c(x * 59), 255};
+                default: return {c(x), c(x), c(x), c(x * 3)};
+            }
+        };
+
+        QImage image{150, 6, QImage::Format_RGBA8888};
+
+        for (int y = 0; y < image.height(); ++y)
+        {
+            for (int x = 0; x < image.width(); ++x)
+            {
+                const auto pixel = pixel_at(x, y);
+                std::copy(pixel.begin(), pixel.end(), image.scanLine(y) + x * 4);
+            }
+        }
+
+        const auto decoded = decode_qoi(QoiEncoder::encode(image));
+
+        QVERIFY(decoded.has_value());
+        QCOMPARE(decoded->width, image.width());
+        QCOMPARE(decoded->height, image.height());
+        QCOMPARE(decoded->channels, 4);
+
+        for (int y = 0; y < image.height(); ++y)
+        {
+            const uchar*   expected = image.constScanLine(y);
+            const uint8_t* actual   = decoded->pixels.data() + size_t(y) * image.width() * 4;
+
+            QVERIFY(std::equal(expected, expected + image.width() * 4, actual));
+        }
+    }
+
+    void gray_round_trip()
+    {
+        QImage image{33, 17, QImage::Format_Grayscale8};
+
+        for (int y = 0; y < image.height(); ++y)
+        {
+            for (int x = 0; x < image.width(); ++x)
+            {
+                image.scanLine(y)[x] = uchar(x < 10 ? 0 : (x * 23 + y * 41) % 256);
+            }
+        }
+
+        const auto decoded = decode_qoi(QoiEncoder::encode(image));
+
+        QVERIFY(decoded.has_value());
+        QCOMPARE(decoded->channels, 3);
+
+        // Gray values are written as opaque colors with equal channels.
+        for (int y = 0; y < image.height(); ++y)
+        {
+            for (int x = 0; x < image.width(); ++x)
+            {
+                const uchar    gray = image.constScanLine(y)[x];
+                const uint8_t* p    = decoded->pixels.data() + (size_t(y) * image.width() + x) * 4;
+
+                QCOMPARE(int(p[0]), int(gray));
+                QCOMPARE(int(p[1]), int(gray));
+                QCOMPARE(int(p[2]), int(gray));
+                QCOMPARE(int(p[3]), 255);
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(TestQoiEncoder)
+
+#include "TestQoiEncoder.moc"
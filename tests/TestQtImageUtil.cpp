@@ -0,0 +1,64 @@
+// Copyright (C) 2021-2024 Cemalettin Dervis
+// This file is part of BMFGen.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "QtImageUtil.hpp"
+#include <QByteArray>
+#include <QTest>
+
+// Packs a row into a zero-initialized buffer, as the bundle export does.
+static QByteArray pack(const QByteArray& gray, int bits_per_pixel)
+{
+    const int  width = int(gray.size());
+    QByteArray packed(QtImageUtil::packed_row_pitch(width, bits_per_pixel), '\0');
+
+    QtImageUtil::pack_gray_row(reinterpret_cast<const uchar*>(gray.constData()),
+                               reinterpret_cast<uchar*>(packed.data()),
+                               width,
+                               bits_per_pixel);
+
+    return packed;
+}
+
+class TestQtImageUtil : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void packed_row_pitch_rounds_up_to_bytes()
+    {
+        QCOMPARE(QtImageUtil::packed_row_pitch(13, 8), qsizetype(13));
+        QCOMPARE(QtImageUtil::packed_row_pitch(13, 4), qsizetype(7));
+        QCOMPARE(QtImageUtil::packed_row_pitch(13, 1), qsizetype(2));
+        QCOMPARE(QtImageUtil::packed_row_pitch(16, 1), qsizetype(2));
+        QCOMPARE(QtImageUtil::packed_row_pitch(0, 4), qsizetype(0));
+    }
+
+    void pack_8_bits_copies_the_row()
+    {
+        const QByteArray gray{"\x00\x01\x7F\x80\xFE\xFF", 6};
+
+        QCOMPARE(pack(gray, 8), gray);
+    }
+
+    void pack_4_bits_rounds_high_nibble_first()
+    {
+        // 8 and 9 lie on either side of the midpoint between levels 0 and 1 (8.5).
+        // The odd width leaves the low nibble of the last byte empty.
+        const QByteArray gray{"\x00\x11\xFF\x08\x09\x80\x88", 7};
+
+        QCOMPARE(pack(gray, 4), QByteArray("\x01\xF0\x18\x80", 4));
+    }
+
+    void pack_1_bit_thresholds_most_significant_bit_first()
+    {
+        // The eleven pixels fill one byte and the three most significant bits of the next one.
+        const QByteArray gray{"\xFF\x00\x80\x7F\x00\x00\x00\xC0\x00\x90\xFF", 11};
+
+        QCOMPARE(pack(gray, 1), QByteArray("\xA1\x60", 2));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestQtImageUtil)
+
+#include "TestQtImageUtil.moc"